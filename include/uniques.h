@@ -5,8 +5,14 @@
 * DESCRIPTION   Operations on ordered sets of unique values
 *
 * HISTORY       2023 01 01   JPT   First implementation
+*               2026 10 18   JPT   Bitmap backend
 *
-* NOTES         -
+* NOTES         The sets are sorted linked lists by default. Defining
+*               UNIQUES_BITMAP switches them to hierarchical bitmaps for
+*               non-negative values, with the same functions: insertion,
+*               deletion and both ends cost O(log64 n) instead of O(n).
+*               The bitmap grows to cover the largest value inserted, so
+*               it suits dense, bounded values such as maze indices.
 *
 \**************************************************************************/
 
@@ -15,12 +21,61 @@
 
 #include <stddef.h>
 #include <stdlib.h>
+#include <limits.h>
+
+#ifdef UNIQUES_BITMAP
+
+#define UNIQUES_MAXLEVELS    6   /* 64^6 exceeds INT_MAX */
+
+typedef struct olist_s {   /* Hierarchical bitmap set of unique values */
+  unsigned long long *bits [UNIQUES_MAXLEVELS];   /* Level 0 holds values */
+  int     levels;          /* Upper level bits flag nonzero words below */
+  int     capacity;        /* Values are limited to [0 .. capacity) */
+} olist_t;
+
+#else
 
 typedef struct olist_s {   /* Element of a set of unique values */
   struct olist_s *next;
   int     val;
 } olist_t;
 
+#endif
+
+#define POOL_SLAB_NODES   4096
+
+typedef struct {           /* Slab allocator for set elements */
+  olist_t **slab;          /* Slabs of POOL_SLAB_NODES nodes each */
+  int     slabs;           /* Number of allocated slabs */
+  int     current;         /* Slab handing out fresh nodes */
+  int     used;            /* Nodes handed out from the current slab */
+  olist_t *freelist;       /* Recycled nodes, linked through next */
+} opool_t;
+
+typedef struct {           /* Element of a keyed heap */
+  long long key;
+  int     val;
+} oheapnode_t;
+
+typedef struct {           /* Binary min-heap of unique values with keys */
+  oheapnode_t *node;       /* Heap ordered by (key, val) */
+  int     *pos;            /* Heap position of each value, -1 if absent */
+  int     size;
+  int     maxval;          /* Values are limited to [0 .. maxval) */
+} oheap_t;
+
+typedef struct {           /* Dial's bucket queue of unique values with keys */
+  int     *head;           /* First value of each bucket, -1 if empty */
+  int     *tail;           /* Last value of each bucket */
+  int     *next;           /* Bucket list links indexed by value */
+  int     *prev;
+  int     *key;            /* Key of each value, -1 if absent */
+  int     buckets;         /* Circular array size, exceeds the key spread */
+  int     lowkey;          /* No key in the queue is smaller than this */
+  int     size;
+  int     maxval;          /* Values are limited to [0 .. maxval) */
+} obucket_t;
+
 
 
 /************************************************************************** \
@@ -68,6 +123,7 @@ void insert_unique(olist_t **olist, int val);
 void delete_unique(olist_t **olist, int val);
 
 
+
 /************************************************************************** \
 *
 * FUNCTION      prune_uniques
@@ -87,6 +143,9 @@ void delete_unique(olist_t **olist, int val);
 *               IMPORTANT: Setting the "next" of a last node is left to
 *               the caller.
 *
+*               Iterative, so long sets do not exhaust the stack. The
+*               bitmap backend accepts the root only.
+*
 \**************************************************************************/
 
 void prune_uniques(olist_t *p);
@@ -179,4 +238,505 @@ int last_unique(olist_t *olist);
 
 void delete_last_unique(olist_t **olist);
 
+
+
+/************************************************************************** \
+*
+* FUNCTION      init_pool
+*
+* DESCRIPTION   Prepares an empty node pool.
+*
+* ARGUMENTS     pool   Pool to initialize [OUTPUT]
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         Slabs are allocated on demand.
+*
+\**************************************************************************/
+
+void init_pool(opool_t *pool);
+
+
+
+/************************************************************************** \
+*
+* FUNCTION      reset_pool
+*
+* DESCRIPTION   Releases every node of the pool in bulk.
+*
+* ARGUMENTS     pool   Pool to reset
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The slabs stay allocated for reuse. All sets built from the
+*               pool become invalid and their roots must be reset to NULL.
+*
+\**************************************************************************/
+
+void reset_pool(opool_t *pool);
+
+
+
+/************************************************************************** \
+*
+* FUNCTION      free_pool
+*
+* DESCRIPTION   Releases the memory of a node pool.
+*
+* ARGUMENTS     pool   Pool to release
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         All sets built from the pool become invalid.
+*
+\**************************************************************************/
+
+void free_pool(opool_t *pool);
+
+
+
+/************************************************************************** \
+*
+* FUNCTION      insert_unique_pooled
+*
+* DESCRIPTION   Inserts an unique value to the set.
+*
+* ARGUMENTS     olist   Set root
+*               val     Value to insert
+*               pool    Node pool (NULL == malloc)
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         As insert_unique(), taking the node from the pool. The
+*               bitmap backend ignores the pool.
+*
+\**************************************************************************/
+
+void insert_unique_pooled(olist_t **olist, int val, opool_t *pool);
+
+
+
+/************************************************************************** \
+*
+* FUNCTION      delete_unique_pooled
+*
+* DESCRIPTION   Finds and deletes an unique value from the set.
+*
+* ARGUMENTS     olist   Set root
+*               val     Value to delete
+*               pool    Node pool (NULL == free)
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         As delete_unique(), recycling the node to the pool.
+*
+\**************************************************************************/
+
+void delete_unique_pooled(olist_t **olist, int val, opool_t *pool);
+
+
+
+/************************************************************************** \
+*
+* FUNCTION      prune_uniques_pooled
+*
+* DESCRIPTION   Deletes the set forward from a given node.
+*
+* ARGUMENTS     p      Deletion start node
+*               pool   Node pool (NULL == free)
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         As prune_uniques(). Prefer reset_pool() when the whole pool
+*               may go at once.
+*
+\**************************************************************************/
+
+void prune_uniques_pooled(olist_t *p, opool_t *pool);
+
+
+
+/************************************************************************** \
+*
+* FUNCTION      delete_first_unique_pooled
+*
+* DESCRIPTION   Deletes the first node from the set.
+*
+* ARGUMENTS     olist   Set root
+*               pool    Node pool (NULL == free)
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         As delete_first_unique(), recycling the node to the pool.
+*
+\**************************************************************************/
+
+void delete_first_unique_pooled(olist_t **olist, opool_t *pool);
+
+
+
+/************************************************************************** \
+*
+* FUNCTION      delete_last_unique_pooled
+*
+* DESCRIPTION   Deletes the last node from the set.
+*
+* ARGUMENTS     olist   Set root
+*               pool    Node pool (NULL == free)
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         As delete_last_unique(), recycling the node to the pool.
+*
+\**************************************************************************/
+
+void delete_last_unique_pooled(olist_t **olist, opool_t *pool);
+
+
+
+/************************************************************************** \
+*
+* FUNCTION      init_heap
+*
+* DESCRIPTION   Allocates an empty keyed heap.
+*
+* ARGUMENTS     heap     Heap to initialize [OUTPUT]
+*               maxval   Upper limit (exclusive) of the stored values
+*
+* GLOBALS       -
+*
+* RETURNS       Error code (0 == Success)
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         IMPORTANT: Allocates heap memory! Release it with
+*               free_heap().
+*
+\**************************************************************************/
+
+int init_heap(oheap_t *heap, int maxval);
+
+
+
+/************************************************************************** \
+*
+* FUNCTION      free_heap
+*
+* DESCRIPTION   Releases the memory of a keyed heap.
+*
+* ARGUMENTS     heap   Heap to release
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         -
+*
+\**************************************************************************/
+
+void free_heap(oheap_t *heap);
+
+
+
+/************************************************************************** \
+*
+* FUNCTION      insert_heap
+*
+* DESCRIPTION   Inserts an unique value with a key to the heap.
+*
+* ARGUMENTS     heap   Heap
+*               val    Value to insert
+*               key    Ordering key of the value
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         A value already in the heap keeps the smaller of its old
+*               and new keys, i.e. the insertion acts as decrease_heap().
+*
+*               The keys are 64-bit, so that a caller may pack a primary
+*               and a secondary ordering criterion into one key.
+*
+\**************************************************************************/
+
+void insert_heap(oheap_t *heap, int val, long long key);
+
+
+
+/************************************************************************** \
+*
+* FUNCTION      decrease_heap
+*
+* DESCRIPTION   Lowers the key of a value in the heap.
+*
+* ARGUMENTS     heap   Heap
+*               val    Value already in the heap
+*               key    New key, smaller than the current one
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         Absent values and keys not smaller than the current one
+*               are ignored.
+*
+\**************************************************************************/
+
+void decrease_heap(oheap_t *heap, int val, long long key);
+
+
+
+/************************************************************************** \
+*
+* FUNCTION      key_heap
+*
+* DESCRIPTION   Return the key of a value in the heap.
+*
+* ARGUMENTS     heap   Heap
+*               val    Inquired value
+*
+* GLOBALS       -
+*
+* RETURNS       Key of the value, LLONG_MAX if the value is absent.
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         -
+*
+\**************************************************************************/
+
+long long key_heap(oheap_t *heap, int val);
+
+
+
+/************************************************************************** \
+*
+* FUNCTION      first_heap
+*
+* DESCRIPTION   Return the value with the smallest (key, value) pair.
+*
+* ARGUMENTS     heap   Heap
+*               key    Key of the value [OUTPUT, may be NULL]
+*
+* GLOBALS       -
+*
+* RETURNS       Node value.
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         Equal keys are resolved by the smaller value.
+*
+\**************************************************************************/
+
+int first_heap(oheap_t *heap, long long *key);
+
+
+
+/************************************************************************** \
+*
+* FUNCTION      delete_first_heap
+*
+* DESCRIPTION   Deletes the first node from the heap.
+*
+* ARGUMENTS     heap   Heap
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         -
+*
+\**************************************************************************/
+
+void delete_first_heap(oheap_t *heap);
+
+
+
+/************************************************************************** \
+*
+* FUNCTION      init_bucket
+*
+* DESCRIPTION   Allocates an empty bucket queue.
+*
+* ARGUMENTS     queue     Queue to initialize [OUTPUT]
+*               maxval    Upper limit (exclusive) of the stored values
+*               maxstep   Largest key increment between a popped value and
+*                         the values inserted after it
+*
+* GLOBALS       -
+*
+* RETURNS       Error code (0 == Success)
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         IMPORTANT: Allocates heap memory! Release it with
+*               free_bucket().
+*
+*               The keys must be non-negative and must never fall below
+*               the key last returned by first_bucket(). A unit cost grid
+*               search uses maxstep = 1, needing only two buckets.
+*
+\**************************************************************************/
+
+int init_bucket(obucket_t *queue, int maxval, int maxstep);
+
+
+
+/************************************************************************** \
+*
+* FUNCTION      free_bucket
+*
+* DESCRIPTION   Releases the memory of a bucket queue.
+*
+* ARGUMENTS     queue   Queue to release
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         -
+*
+\**************************************************************************/
+
+void free_bucket(obucket_t *queue);
+
+
+
+/************************************************************************** \
+*
+* FUNCTION      insert_bucket
+*
+* DESCRIPTION   Inserts an unique value with a key to the queue.
+*
+* ARGUMENTS     queue   Queue
+*               val     Value to insert
+*               key     Ordering key of the value
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         A value already in the queue keeps the smaller of its old
+*               and new keys. Runs in constant time.
+*
+\**************************************************************************/
+
+void insert_bucket(obucket_t *queue, int val, int key);
+
+
+
+/************************************************************************** \
+*
+* FUNCTION      key_bucket
+*
+* DESCRIPTION   Return the key of a value in the queue.
+*
+* ARGUMENTS     queue   Queue
+*               val     Inquired value
+*
+* GLOBALS       -
+*
+* RETURNS       Key of the value, INT_MAX if the value is absent.
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         -
+*
+\**************************************************************************/
+
+int key_bucket(obucket_t *queue, int val);
+
+
+
+/************************************************************************** \
+*
+* FUNCTION      first_bucket
+*
+* DESCRIPTION   Return a value with the smallest key.
+*
+* ARGUMENTS     queue   Queue, must not be empty
+*               key     Key of the value [OUTPUT, may be NULL]
+*
+* GLOBALS       -
+*
+* RETURNS       Node value.
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         Values with equal keys come out in insertion order.
+*
+*               Advances the circular array to the first non-empty bucket,
+*               which costs at most maxstep + 1 probes.
+*
+\**************************************************************************/
+
+int first_bucket(obucket_t *queue, int *key);
+
+
+
+/************************************************************************** \
+*
+* FUNCTION      delete_first_bucket
+*
+* DESCRIPTION   Deletes the first node from the queue.
+*
+* ARGUMENTS     queue   Queue
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         -
+*
+\**************************************************************************/
+
+void delete_first_bucket(obucket_t *queue);
+
 #endif
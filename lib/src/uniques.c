@@ -10,21 +10,306 @@
 *
 \**************************************************************************/
 
+#include <string.h>
 #include "../../include/uniques.h"
 
 
 
+void init_pool(opool_t *pool)
+{
+  pool -> slab     = NULL;
+  pool -> slabs    = 0;
+  pool -> current  = 0;
+  pool -> used     = 0;
+  pool -> freelist = NULL;
+}
+
+
+
+void reset_pool(opool_t *pool)
+{
+  pool -> current  = 0;
+  pool -> used     = 0;
+  pool -> freelist = NULL;
+}
+
+
+
+void free_pool(opool_t *pool)
+{
+  for (int i = 0; i < pool -> slabs; i++) free(pool -> slab [i]);
+  free(pool -> slab);
+  init_pool(pool);
+}
+
+
+
+#ifdef UNIQUES_BITMAP
+
+static int lowbit(unsigned long long w)
+{
+#ifdef __GNUC__
+  return (__builtin_ctzll(w));
+#else
+  int b = 0;
+  while ((w & 1ULL) == 0) {w >>= 1; b++;}
+  return (b);
+#endif
+}
+
+
+
+static int highbit(unsigned long long w)
+{
+#ifdef __GNUC__
+  return (63 - __builtin_clzll(w));
+#else
+  int b = 63;
+  while ((w & (1ULL << 63)) == 0) {w <<= 1; b--;}
+  return (b);
+#endif
+}
+
+
+
+static int bitmap_words(int capacity, int level)
+{
+  long long words = capacity;
+  for (int l = 0; l <= level; l++) words = (words + 63) / 64;
+  return ((int) words);
+}
+
+
+
+static void free_bitmap(olist_t *olist)
+{
+  for (int l = 0; l < olist -> levels; l++) free(olist -> bits [l]);
+  free(olist);
+}
+
+
+
+static olist_t *new_bitmap(int capacity)   /* Empty set of given capacity */
+{
+  olist_t *olist = (olist_t *) calloc(1, sizeof (olist_t));
+  if (olist == NULL) return (NULL);
+  olist -> capacity = capacity;
+  do {
+    int words = bitmap_words(capacity, olist -> levels);
+    olist -> bits [olist -> levels] =
+      (unsigned long long *) calloc(words, sizeof (unsigned long long));
+    if (olist -> bits [olist -> levels ++] == NULL) {
+      free_bitmap(olist);
+      return (NULL);
+    }
+    if (words == 1) break;
+  } while (olist -> levels < UNIQUES_MAXLEVELS);
+  return (olist);
+}
+
+
+
+static void set_bitmap(olist_t *olist, int val)
+{
+  for (int l = 0; l < olist -> levels; l++, val >>= 6) {
+    olist -> bits [l] [val >> 6] |= 1ULL << (val & 63);
+  }
+}
+
+
+
+static int grow_bitmap(olist_t **olist, int val)   /* Capacity beyond val */
+{
+  olist_t *grown;
+  int capacity = (*olist) -> capacity;
+  while (capacity <= val) {
+    capacity = (capacity > INT_MAX / 2) ? INT_MAX : 2 * capacity;
+  }
+  grown = new_bitmap(capacity);
+  if (grown == NULL) return (1);
+  for (int w = 0; w < bitmap_words((*olist) -> capacity, 0); w++) {
+    unsigned long long word = (*olist) -> bits [0] [w];
+    int v = w;
+    if (word == 0) continue;
+    grown -> bits [0] [w] = word;
+    for (int l = 1; l < grown -> levels; l++, v >>= 6) {
+      grown -> bits [l] [v >> 6] |= 1ULL << (v & 63);
+    }
+  }
+  free_bitmap(*olist);
+  *olist = grown;
+  return (0);
+}
+
+
+
+void insert_unique(olist_t **olist, int val)
+{
+  insert_unique_pooled(olist, val, NULL);
+}
+
+
+
+void insert_unique_pooled(olist_t **olist, int val, opool_t *pool)
+{
+  if ((val < 0) || (val == INT_MAX)) return;
+  if (*olist == NULL) {
+    int capacity = 64;
+    while (capacity <= val) {
+      capacity = (capacity > INT_MAX / 2) ? INT_MAX : 2 * capacity;
+    }
+    *olist = new_bitmap(capacity);
+    if (*olist == NULL) return;
+  }
+  if ((val >= (*olist) -> capacity) && grow_bitmap(olist, val)) return;
+  set_bitmap(*olist, val);
+}
+
+
+
+void delete_unique(olist_t **olist, int val)
+{
+  delete_unique_pooled(olist, val, NULL);
+}
+
+
+
+void delete_unique_pooled(olist_t **olist, int val, opool_t *pool)
+{
+  olist_t *p = *olist;
+  if ((p == NULL) || (val < 0) || (val >= p -> capacity)) return;
+  for (int l = 0; l < p -> levels; l++, val >>= 6) {
+    p -> bits [l] [val >> 6] &= ~(1ULL << (val & 63));
+    if (p -> bits [l] [val >> 6]) return;   /* Upper levels still valid */
+  }
+  free_bitmap(p);   /* Top word emptied, so is the set */
+  *olist = NULL;
+}
+
+
+
+void prune_uniques(olist_t *p)   /* See header file notes */
+{
+  prune_uniques_pooled(p, NULL);
+}
+
+
+
+void prune_uniques_pooled(olist_t *p, opool_t *pool)
+{
+  if (p) free_bitmap(p);
+}
+
+
+
+int first_unique(olist_t *olist)
+{
+  int idx = 0;
+  for (int l = olist -> levels - 1; l >= 0; l--) {
+    idx = idx * 64 + lowbit(olist -> bits [l] [idx]);
+  }
+  return (idx);
+}
+
+
+
+void delete_first_unique(olist_t **olist)
+{
+  delete_unique_pooled(olist, first_unique(*olist), NULL);
+}
+
+
+
+void delete_first_unique_pooled(olist_t **olist, opool_t *pool)
+{
+  delete_unique_pooled(olist, first_unique(*olist), pool);
+}
+
+
+
+int last_unique(olist_t *olist)
+{
+  int idx = 0;
+  for (int l = olist -> levels - 1; l >= 0; l--) {
+    idx = idx * 64 + highbit(olist -> bits [l] [idx]);
+  }
+  return (idx);
+}
+
+
+
+void delete_last_unique(olist_t **olist)
+{
+  delete_unique_pooled(olist, last_unique(*olist), NULL);
+}
+
+
+
+void delete_last_unique_pooled(olist_t **olist, opool_t *pool)
+{
+  delete_unique_pooled(olist, last_unique(*olist), pool);
+}
+
+#else
+
+static olist_t *new_node(opool_t *pool)
+{
+  olist_t *n;
+  if (pool == NULL) return ((olist_t *) malloc(sizeof (olist_t)));
+  if (pool -> freelist) {
+    n = pool -> freelist;
+    pool -> freelist = n -> next;
+    return (n);
+  }
+  if (pool -> used == POOL_SLAB_NODES) {
+    pool -> current ++;
+    pool -> used = 0;
+  }
+  if (pool -> current == pool -> slabs) {
+    olist_t **slab = (olist_t **) realloc(pool -> slab,
+                                          (pool -> slabs + 1) * sizeof (olist_t *));
+    if (slab == NULL) return (NULL);
+    pool -> slab = slab;
+    pool -> slab [pool -> slabs] =
+      (olist_t *) malloc(POOL_SLAB_NODES * sizeof (olist_t));
+    if (pool -> slab [pool -> slabs] == NULL) return (NULL);
+    pool -> slabs ++;
+  }
+  return (&(pool -> slab [pool -> current] [pool -> used ++]));
+}
+
+
+
+static void recycle_node(opool_t *pool, olist_t *p)
+{
+  if (pool == NULL) {
+    free(p);
+    return;
+  }
+  p -> next = pool -> freelist;
+  pool -> freelist = p;
+}
+
+
+
 void insert_unique(olist_t **olist, int val)
+{
+  insert_unique_pooled(olist, val, NULL);
+}
+
+
+
+void insert_unique_pooled(olist_t **olist, int val, opool_t *pool)
 {
   olist_t *p, *n;
   if (*olist == NULL) {
-    *olist = (olist_t *) malloc(sizeof (olist_t));
+    *olist = new_node(pool);
     (*olist) -> next = NULL;
     (*olist) -> val = val;
     return;
   }
   if ((*olist) -> val > val) {
-    n = (olist_t *) malloc(sizeof (olist_t));
+    n = new_node(pool);
     n -> next = (*olist);
     *olist = n;
     n -> val = val;
@@ -34,7 +319,7 @@ void insert_unique(olist_t **olist, int val)
     if (p -> val == val) return;
     if (p -> val < val) {
       if ((p -> next == NULL) || (p -> next -> val > val)) {
-        n = (olist_t *) malloc(sizeof (olist_t));
+        n = new_node(pool);
         n -> next = p -> next;
         p -> next = n;
         n -> val = val;
@@ -47,18 +332,25 @@ void insert_unique(olist_t **olist, int val)
 
 
 void delete_unique(olist_t **olist, int val)
+{
+  delete_unique_pooled(olist, val, NULL);
+}
+
+
+
+void delete_unique_pooled(olist_t **olist, int val, opool_t *pool)
 {
   olist_t *p, *n, *prev;
   if (*olist == NULL) return;
   if ((*olist) -> val == val) {
     if ((*olist) -> next == NULL) {
-      free(*olist);
+      recycle_node(pool, *olist);
       *olist = NULL;
       return;
     }
     else {
       n = (*olist) -> next;
-      free(*olist);
+      recycle_node(pool, *olist);
       *olist = n;
       return;
     }
@@ -67,7 +359,7 @@ void delete_unique(olist_t **olist, int val)
     if (p -> val == val) {
       if (p -> next != NULL) prev -> next = p -> next;
       else prev -> next = NULL;
-      free(p);
+      recycle_node(pool, p);
       return;
     }
   }
@@ -77,10 +369,18 @@ void delete_unique(olist_t **olist, int val)
 
 void prune_uniques(olist_t *p)   /* See header file notes */
 {
-  if (p == NULL) return;
-  if (p -> next) prune_uniques(p -> next);
-  free(p);
-  return;
+  prune_uniques_pooled(p, NULL);
+}
+
+
+
+void prune_uniques_pooled(olist_t *p, opool_t *pool)
+{
+  while (p) {
+    olist_t *n = p -> next;
+    recycle_node(pool, p);
+    p = n;
+  }
 }
 
 
@@ -90,15 +390,22 @@ int first_unique(olist_t *olist) {return (olist -> val);}
 
 
 void delete_first_unique(olist_t **olist)
+{
+  delete_first_unique_pooled(olist, NULL);
+}
+
+
+
+void delete_first_unique_pooled(olist_t **olist, opool_t *pool)
 {
   olist_t *p;
   if ((*olist) -> next == NULL) {
-    free(*olist);
+    recycle_node(pool, *olist);
     *olist = NULL;
     return;
   }
   p = (*olist) -> next;
-  free(*olist);
+  recycle_node(pool, *olist);
   *olist = p;
 }
 
@@ -114,15 +421,266 @@ int last_unique(olist_t *olist)
 
 
 void delete_last_unique(olist_t **olist)
+{
+  delete_last_unique_pooled(olist, NULL);
+}
+
+
+
+void delete_last_unique_pooled(olist_t **olist, opool_t *pool)
 {
   olist_t *p, *prev;
   if ((*olist) -> next == NULL) {
-    free(*olist);
+    recycle_node(pool, *olist);
     *olist = NULL;
     return;
   }
-  for (prev = *olist, p = (*olist) -> next; p -> next; prev = p, p = p -> next) {
-    free(p);
-    prev -> next = NULL;
+  for (prev = *olist, p = (*olist) -> next; p -> next; prev = p, p = p -> next);
+  recycle_node(pool, p);
+  prev -> next = NULL;
+}
+
+#endif
+
+
+
+static int less_heapnode(oheapnode_t *a, oheapnode_t *b)
+{
+  return ((int) (   (a -> key < b -> key)
+                 || ((a -> key == b -> key) && (a -> val < b -> val))));
+}
+
+
+
+static void swap_heapnodes(oheap_t *heap, int i, int j)
+{
+  oheapnode_t t = heap -> node [i];
+  heap -> node [i] = heap -> node [j];
+  heap -> node [j] = t;
+  heap -> pos [heap -> node [i].val] = i;
+  heap -> pos [heap -> node [j].val] = j;
+}
+
+
+
+static void sift_up_heap(oheap_t *heap, int i)
+{
+  while (i > 0) {
+    int parent = (i - 1) / 2;
+    if (! less_heapnode(&(heap -> node [i]), &(heap -> node [parent]))) break;
+    swap_heapnodes(heap, i, parent);
+    i = parent;
   }
 }
+
+
+
+static void sift_down_heap(oheap_t *heap, int i)
+{
+  while (1) {
+    int least = i;
+    int left  = 2 * i + 1;
+    int right = left + 1;
+    if (   (left < heap -> size)
+        && less_heapnode(&(heap -> node [left]), &(heap -> node [least]))) {
+      least = left;
+    }
+    if (   (right < heap -> size)
+        && less_heapnode(&(heap -> node [right]), &(heap -> node [least]))) {
+      least = right;
+    }
+    if (least == i) break;
+    swap_heapnodes(heap, i, least);
+    i = least;
+  }
+}
+
+
+
+int init_heap(oheap_t *heap, int maxval)
+{
+  heap -> size   = 0;
+  heap -> maxval = maxval;
+  heap -> node   = (oheapnode_t *) malloc(maxval * sizeof (oheapnode_t));
+  heap -> pos    = (int *) malloc(maxval * sizeof (int));
+  if ((heap -> node == NULL) || (heap -> pos == NULL)) {
+    free_heap(heap);
+    return (1);
+  }
+  memset(heap -> pos, (unsigned char) 0xff, maxval * sizeof (int));   /* -1 */
+  return (0);
+}
+
+
+
+void free_heap(oheap_t *heap)
+{
+  free(heap -> node);
+  free(heap -> pos);
+  heap -> node   = NULL;
+  heap -> pos    = NULL;
+  heap -> size   = 0;
+  heap -> maxval = 0;
+}
+
+
+
+void insert_heap(oheap_t *heap, int val, long long key)
+{
+  int i;
+  if ((val < 0) || (val >= heap -> maxval)) return;
+  if (heap -> pos [val] != -1) {
+    decrease_heap(heap, val, key);
+    return;
+  }
+  i = heap -> size ++;
+  heap -> node [i].key = key;
+  heap -> node [i].val = val;
+  heap -> pos [val] = i;
+  sift_up_heap(heap, i);
+}
+
+
+
+void decrease_heap(oheap_t *heap, int val, long long key)
+{
+  int i;
+  if ((val < 0) || (val >= heap -> maxval)) return;
+  i = heap -> pos [val];
+  if ((i == -1) || (heap -> node [i].key <= key)) return;
+  heap -> node [i].key = key;
+  sift_up_heap(heap, i);
+}
+
+
+
+long long key_heap(oheap_t *heap, int val)
+{
+  if ((val < 0) || (val >= heap -> maxval)) return (LLONG_MAX);
+  if (heap -> pos [val] == -1) return (LLONG_MAX);
+  return (heap -> node [heap -> pos [val]].key);
+}
+
+
+
+int first_heap(oheap_t *heap, long long *key)
+{
+  if (key) *key = heap -> node [0].key;
+  return (heap -> node [0].val);
+}
+
+
+
+void delete_first_heap(oheap_t *heap)
+{
+  if (heap -> size == 0) return;
+  heap -> pos [heap -> node [0].val] = -1;
+  heap -> size --;
+  if (heap -> size == 0) return;
+  heap -> node [0] = heap -> node [heap -> size];
+  heap -> pos [heap -> node [0].val] = 0;
+  sift_down_heap(heap, 0);
+}
+
+
+
+int init_bucket(obucket_t *queue, int maxval, int maxstep)
+{
+  queue -> buckets = maxstep + 1;
+  queue -> lowkey  = 0;
+  queue -> size    = 0;
+  queue -> maxval  = maxval;
+  queue -> head = (int *) malloc(queue -> buckets * sizeof (int));
+  queue -> tail = (int *) malloc(queue -> buckets * sizeof (int));
+  queue -> next = (int *) malloc(maxval * sizeof (int));
+  queue -> prev = (int *) malloc(maxval * sizeof (int));
+  queue -> key  = (int *) malloc(maxval * sizeof (int));
+  if (   (queue -> head == NULL) || (queue -> tail == NULL)
+      || (queue -> next == NULL) || (queue -> prev == NULL)
+      || (queue -> key  == NULL)) {
+    free_bucket(queue);
+    return (1);
+  }
+  memset(queue -> head, (unsigned char) 0xff, queue -> buckets * sizeof (int));
+  memset(queue -> tail, (unsigned char) 0xff, queue -> buckets * sizeof (int));
+  memset(queue -> key,  (unsigned char) 0xff, maxval * sizeof (int));   /* -1 */
+  return (0);
+}
+
+
+
+void free_bucket(obucket_t *queue)
+{
+  free(queue -> head);
+  free(queue -> tail);
+  free(queue -> next);
+  free(queue -> prev);
+  free(queue -> key);
+  queue -> head = queue -> tail = NULL;
+  queue -> next = queue -> prev = queue -> key = NULL;
+  queue -> size   = 0;
+  queue -> maxval = 0;
+}
+
+
+
+static void unlink_bucket(obucket_t *queue, int val)
+{
+  int b = queue -> key [val] % queue -> buckets;
+  if (queue -> prev [val] == -1) queue -> head [b] = queue -> next [val];
+  else queue -> next [queue -> prev [val]] = queue -> next [val];
+  if (queue -> next [val] == -1) queue -> tail [b] = queue -> prev [val];
+  else queue -> prev [queue -> next [val]] = queue -> prev [val];
+  queue -> key [val] = -1;
+  queue -> size --;
+}
+
+
+
+void insert_bucket(obucket_t *queue, int val, int key)
+{
+  int b;
+  if ((val < 0) || (val >= queue -> maxval) || (key < 0)) return;
+  if (queue -> key [val] != -1) {
+    if (queue -> key [val] <= key) return;
+    unlink_bucket(queue, val);
+  }
+  if ((queue -> size == 0) || (key < queue -> lowkey)) queue -> lowkey = key;
+  b = key % queue -> buckets;
+  queue -> key  [val] = key;
+  queue -> next [val] = -1;
+  queue -> prev [val] = queue -> tail [b];
+  if (queue -> tail [b] == -1) queue -> head [b] = val;
+  else queue -> next [queue -> tail [b]] = val;
+  queue -> tail [b] = val;
+  queue -> size ++;
+}
+
+
+
+int key_bucket(obucket_t *queue, int val)
+{
+  if ((val < 0) || (val >= queue -> maxval)) return (INT_MAX);
+  if (queue -> key [val] == -1) return (INT_MAX);
+  return (queue -> key [val]);
+}
+
+
+
+int first_bucket(obucket_t *queue, int *key)
+{
+  int val;
+  while ((val = queue -> head [queue -> lowkey % queue -> buckets]) == -1) {
+    queue -> lowkey ++;
+  }
+  if (key) *key = queue -> key [val];
+  return (val);
+}
+
+
+
+void delete_first_bucket(obucket_t *queue)
+{
+  if (queue -> size == 0) return;
+  unlink_bucket(queue, first_bucket(queue, NULL));
+}
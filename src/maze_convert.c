@@ -0,0 +1,84 @@
+/**************************************************************************\
+*
+* PROGRAM       maze_convert
+*
+* DESCRIPTION   Converts mazes between the text and the binary format
+*
+* ARGUMENTS     Input file name, output file name
+*
+* RETURNS       Error status (0 == Success)
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The program functions are included with
+*               maze_solver_functions.c, as in maze_solver.c. The binary
+*               format is described with packmaze().
+*
+\**************************************************************************/
+
+#include "maze_solver_functions.c"
+
+/************************************************************************** \
+*
+* FUNCTION      main
+*
+* DESCRIPTION   Program entry point
+*
+* ARGUMENTS     argc   Command line argument count
+*               argv   Command line argument vector (See NOTES)
+*
+* GLOBALS       -
+*
+* RETURNS       Error code (0 == Success)
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The program is invoked by
+*
+*                 maze_convert <input_file> <output_file>
+*
+*               A text maze is written in the binary format and a binary
+*               maze in the text format. The input is loaded and checked
+*               by mazeinit() in either case.
+*
+\**************************************************************************/
+
+int main (int argc, char *argv [])
+{
+  mazeparam_t mazeparam;
+  char        *maze = NULL;
+  char        magic [4] = {0};
+  int         binary = 0;
+  int         rv = 0;
+  FILE        *f;
+  if (argc != 3) {
+    printf("Use: maze_convert <input_file> <output_file>\n");
+    return (1);
+  }
+  f = fopen(argv [1], "rb");
+  if (f == NULL) {
+    perror("Cannot open input file");
+    return (1);
+  }
+  binary = (int) (   (fread(magic, 4, 1, f) == 1)
+                  && (memcmp(magic, MAZEBIN_MAGIC, 4) == 0));
+  fclose(f);
+  if (mazeinit(argv [1], &maze, &mazeparam)) return (1);
+  f = fopen(argv [2], binary ? "w" : "wb");
+  if (f == NULL) {
+    perror("Cannot open output file");
+    free(maze);
+    return (1);
+  }
+  if (binary) {
+    mazeparam.out = f;
+    rv = printmaze(maze, &mazeparam, 0);
+  }
+  else rv = packmaze(maze, &mazeparam, f);
+  if (fclose(f) != 0) {
+    perror("Cannot write output file");
+    rv = 1;
+  }
+  free(maze);
+  return (rv);
+}
@@ -27,30 +27,90 @@
 * ARGUMENTS     argc   Command line argument count
 *               argv   Command line argument vector (See NOTES)
 *
-* GLOBALS       -
+* GLOBALS       algorithms
 *
 * RETURNS       Error code (0 == Success)
 *
 * HISTORY       2023 01 01   JPT   First implementation
+*               2026 10 18   JPT   Algorithm selection
+*               2026 10 18   JPT   Batch mode
+*               2026 10 18   JPT   Run-length rows
+*               2026 10 18   JPT   Walker budget
 *
-* NOTES         The program is invoked by "maze_solver <maze_file>"
+* NOTES         The program is invoked by
+*
+*                 maze_solver [-a <algorithm>]... [-j <threads>] [-r]
+*                             [-s <steps>] [-t <seconds>]
+*                             [-l <manifest>]... <maze_file>...
+*
+*               Without -a, Dijkstra, Pledge and Wall Follower are run.
+*               A maze file may also be a directory of maze files, and a
+*               manifest lists further files, one per line. Several files
+*               are solved on a thread per processor unless -j tells
+*               otherwise. The results are printed in the command line
+*               order in any case. With -r, the mazes are kept in memory
+*               as run-length encoded rows. -s and -t limit the steps and
+*               the seconds of a Pledge or wall follower walk, which is
+*               given up as unsolvable beyond them.
 *
 \**************************************************************************/
 
 int main (int argc, char *argv [])
 {
-  char filename [PATH_MAX];
-  int  rv = 0;
-  if (argc < 2) {
-    printf("Missing input file. Use: maze_solver <maze_file>\n");
+  filelist_t  list;
+  algorithm_t *chosen [sizeof (algorithms) / sizeof (algorithms [0])];
+  int         nchosen = 0;
+  int         threads = 0;
+  int         rle = 0;
+  budget_t    budget = {0, 0};
+  int         rv = 0;
+  memset(&list, 0, sizeof (filelist_t));
+  for (int i = 1; i < argc; i++) {
+    if ((strcmp(argv [i], "-a") == 0) && (i + 1 < argc)) {
+      algorithm_t *a = findalgorithm(argv [++i]);
+      if (a == NULL) {
+        printf("Unknown algorithm %s. Choose from:", argv [i]);
+        for (a = algorithms; a -> name; a++) printf(" %s", a -> name);
+        printf("\n");
+        free_filelist(&list);
+        return (1);
+      }
+      if (nchosen < (int) (sizeof (chosen) / sizeof (chosen [0]))) {
+        chosen [nchosen ++] = a;
+      }
+    }
+    else if ((strcmp(argv [i], "-j") == 0) && (i + 1 < argc)) {
+      threads = atoi(argv [++i]);
+    }
+    else if (strcmp(argv [i], "-r") == 0) rle = 1;
+    else if ((strcmp(argv [i], "-s") == 0) && (i + 1 < argc)) {
+      budget.steps = atoll(argv [++i]);
+    }
+    else if ((strcmp(argv [i], "-t") == 0) && (i + 1 < argc)) {
+      budget.seconds = atof(argv [++i]);
+    }
+    else if ((strcmp(argv [i], "-l") == 0) && (i + 1 < argc)) {
+      rv = read_manifest(&list, argv [++i]);
+    }
+    else rv = add_mazefile(&list, argv [i]);
+    if (rv) {
+      free_filelist(&list);
+      return (rv);
+    }
+  }
+  if (list.files == 0) {
+    printf("Missing input file. Use: maze_solver [-a <algorithm>]... "
+           "[-j <threads>] [-r] [-s <steps>] [-t <seconds>] "
+           "[-l <manifest>]... <maze_file>...\n");
     return (1);
   }
-  strcpy(filename, argv [1]);
-  printf("---- DIJKSTRA --------------------------\n\n");
-  rv += solvemaze(dijkstra, filename, 0);
-  printf("---- PLEDGE ----------------------------\n\n");
-  rv += solvemaze(pledge, filename, PLEDGE_ENABLE);
-  printf("---- WALL FOLLOWER ---------------------\n\n");
-  rv += solvemaze(pledge, filename, 0);
+  if (nchosen == 0) {
+    for (algorithm_t *a = algorithms; a -> name; a++) {
+      if (a -> classic) chosen [nchosen ++] = a;
+    }
+  }
+  if (threads <= 0) threads = (list.files > 1) ? cpu_count() : 1;
+  rv = run_batch(&list, chosen, nchosen, threads, rle, budget, stdout);
+  free_filelist(&list);
   return (rv);
 }
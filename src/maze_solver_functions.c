@@ -21,13 +21,80 @@
 #include <ctype.h>
 #include <string.h>
 #include <limits.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <time.h>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
 #include "../include/uniques.h"
 
-#define MAX_ALLOWED_ROWLENGTH   1021
 #define MAX_EXITS                  4
 #define PLEDGE_ENABLE           0x01
+#define BUCKET_FRONTIER         0x02
+#define LIST_FRONTIER           0x04
+#define WALL_HEURISTIC          0x08
+#define JUNCTION_GRAPH          0x10
+#define HPA_GRAPH               0x20
+#define LARGE_MAZES             0x40
+#define OUT_OF_CORE             0x80
+#define HPA_CLUSTER_SIZE          16
+#define HPA_LONG_ENTRANCE          6
+#define HPA_SMOOTH_WINDOW          8
+#define TILE_SIZE                256
+#define TILE_CACHE_SLOTS        4096
+#define MAZEBIN_MAGIC         "MAZB"
+#define MAZEBIN_VERSION            1
+#define MAZEBIN_HEADER            64
+#define CELL_WALKABLE           0x10
+#define CELL_NEXTTO_EXIT        0x20
+#define CELL_EXIT               0x40
 
 enum {START_EDGE, START_INSIDE};
+enum {FRONTIER_HEAP, FRONTIER_BUCKET, FRONTIER_LIST};
+enum {SOLVE_OK, SOLVE_NOT_FOUND, SOLVE_REFUSED, SOLVE_UNSOLVABLE};
+enum {WALK_ON, WALK_CYCLE, WALK_OVER_BUDGET, WALK_GOAL};
+
+typedef struct {
+  int  nodes;
+  int  edges;
+  int  *node;       /* Linear index of each node */
+  int  *nodeof;     /* Node of each square, -1 for walls and corridors */
+  int  *to;         /* Node reached by each heading of a node, -1 if none */
+  int  *len;        /* Steps taken by each heading of a node */
+} junction_graph_t;
+
+typedef struct {
+  int    size;        /* Cluster side in squares */
+  int    crows;       /* Clusters per column */
+  int    ccols;       /* Clusters per row */
+  int    clusters;
+  int    nodes;
+  int    *node;       /* Linear index of each node, sorted within clusters */
+  int    *first;      /* First node of each cluster, one extra at the end */
+  int    *across;     /* Node across a border by each heading, -1 if none */
+  size_t *offset;     /* Start of the distance matrix of each cluster */
+  int    *dist;       /* Distances between the nodes of a cluster, -1 if none */
+} hpa_graph_t;
+
+typedef struct {
+  int       rows;       /* Rows encoded so far */
+  long long rowcap;     /* Allocated rows of first */
+  long long runs;
+  long long runcap;     /* Allocated runs of start and square */
+  long long *first;     /* First run of each row, one extra at the end */
+  int       *start;     /* Starting column of each run */
+  char      *square;    /* Square character of each run */
+} rlemaze_t;
+
+typedef struct {
+  long long steps;     /* Steps allowed to a walker, 0 for no limit */
+  double    seconds;   /* Seconds allowed to a walker, 0 for no limit */
+} budget_t;
 
 typedef struct {
   int rows;
@@ -39,28 +106,217 @@ typedef struct {
   int exitcol [MAX_EXITS];
   int exits;
   int pledge_enable;
+  int wall_heuristic;
+  int frontier;
   olist_t *olist;
+  opool_t opool;
+  oheap_t oheap;
+  obucket_t obucket;
+  junction_graph_t *graph;
+  hpa_graph_t *hpa;
+  int threads;   /* Worker threads, 0 for one per processor */
+  FILE *out;     /* Destination of the printed results */
+  char *overlay; /* Markers of the running solver, 0 where none */
+  rlemaze_t *rle; /* Run-length rows in place of the maze, NULL if none */
+  unsigned char *cellmask; /* Padded wall mask layer, NULL if none */
+  budget_t budget; /* Limits of pledge(), zeros for none */
 } mazeparam_t;
 
 typedef struct {
-  int row; int col; int idx; char atval;
-  int steps;
-  int unfolded_heading;
-  int folded_heading;
-  int northrow; int northcol; int northidx; char northval;
-  int eastrow;  int eastcol;  int eastidx;  char eastval;
-  int southrow; int southcol; int southidx; char southval;
-  int westrow;  int westcol;  int westidx;  char westval;
-  int aheadrow; int aheadcol; int aheadidx; char aheadval;
-  int siderow;  int sidecol;  int sideidx;  char sideval;
+  pthread_mutex_t  lock;
+  int              refs;       /* Runs still to use the cache */
+  int              loaded;     /* 1 loaded, -1 failed, 0 not tried yet */
+  char             *maze;      /* Shared read-only by the runs */
+  int              rle;        /* Load the maze as run-length rows */
+  rlemaze_t        runs;       /* The rows, if so */
+  budget_t         budget;     /* Limits of the wall walkers */
+  int              threads;    /* Threads of one run, 0 for one per processor */
+  mazeparam_t      param;      /* Parameters harvested by mazeinit() */
+  junction_graph_t junction;
+  hpa_graph_t      hpa;
+} mazecache_t;
+
+typedef struct {
+  long long idx;          /* Linear index of the square */
+  long long offset [4];   /* Index offsets of the folded headings */
+  int       row;
+  int       col;
+  long long steps;
+  int       unfolded_heading;
+  int       folded_heading;
 } pentti_t;
 
 typedef struct {
-  int row;
-  int col;
+  long long       idx;        /* Square of the saved state */
+  int             heading;    /* Unfolded heading of the saved state */
+  int             crossed;    /* Flag for a zero heading since then */
+  long long       power;      /* Moves before the state is saved again */
+  long long       length;     /* Moves since the saved state */
+  long long       moves;      /* Moves in total */
+  struct timespec start;      /* Starting time of the walk */
+} walkguard_t;
+
+typedef unsigned long long bitword_t;
+
+typedef struct {
+  unsigned char *dir;   /* 2-bit headings towards the parent, 4 per byte */
+  bitword_t     *known; /* Squares having a parent */
+  int           root;   /* Linear index of the square parenting itself */
 } parent_data_t;
 
-typedef int (* solver_t) (pentti_t *, char *, mazeparam_t *);
+typedef struct solve solve_t;
+typedef struct observer observer_t;
+
+struct observer {
+  int        until;    /* Steps below which visit() is called */
+  void       (* visit) (observer_t *, solve_t *);
+  void       (* finish) (observer_t *, solve_t *);
+  void       *data;    /* Own data of the observer */
+  observer_t *next;
+};
+
+struct solve {
+  pentti_t      *pentti;
+  const char    *maze;
+  mazeparam_t   *mazeparam;
+  observer_t    *observers;
+  int           until;        /* Largest until of the observers */
+  int           done;         /* Flag for nothing left to step */
+  int           status;       /* SOLVE_ status, -1 until known */
+  long long     moves;        /* Moves stepped so far */
+  int           (* step) (solve_t *, long long);
+  int           (* finish) (solve_t *);
+  walkguard_t   guard;        /* The rest for the wall walkers */
+  int           walk;
+  int           trailwall;
+  int           fast;         /* Flag for follow_walls() taken over */
+  bitword_t     *exclusion;   /* The rest for Dijkstra */
+  parent_data_t parent_layer;
+  int           found;
+};
+
+typedef struct {
+  int       status;
+  long long steps;
+  long long moves;
+} metrics_t;
+
+typedef struct {
+  hpa_graph_t *graph;
+  const char  *maze;
+  mazeparam_t *mazeparam;
+  int         thread;    /* Number of this thread */
+  int         threads;   /* Number of threads sharing the clusters */
+  int         err;
+} hpa_work_t;
+
+typedef struct bfs_pool bfs_pool_t;
+
+typedef struct {
+  bfs_pool_t *pool;
+  int        thread;     /* Number of this thread */
+  int        *local;     /* Squares claimed in the current layer */
+  int        size;
+  int        capacity;
+  int        err;
+} bfs_work_t;
+
+struct bfs_pool {
+  const char        *maze;
+  mazeparam_t       *mazeparam;
+  int               threads;
+  bfs_work_t        *work;       /* One per thread */
+  pthread_mutex_t   gate;        /* Holds the threads until all started */
+  pthread_barrier_t barrier;     /* Separates the phases of a layer */
+  int               *frontier;   /* Squares of the current layer */
+  int               *next;       /* Squares of the next layer */
+  int               size;        /* Squares in the current layer */
+  int               *distance;   /* Layer of each square, -1 if not reached */
+  bitword_t         *visited;    /* Claimed squares, set atomically */
+  int               layer;
+  int               goalidx;     /* Smallest goal square found, -1 if none */
+  int               done;
+  solve_t           *solve;      /* Observers of the layers */
+};
+
+typedef struct {
+  long long     tile;    /* Tile held by the slot, -1 if none */
+  int           dirty;   /* State changed since loaded */
+  int           prev;    /* Next more recently used slot, -1 if none */
+  int           next;    /* Next less recently used slot, -1 if none */
+  unsigned char *wall;   /* 1 where not walkable, row by row */
+  unsigned char *state;  /* 0 unreached, 1 + heading of arrival, 5 start */
+} tileslot_t;
+
+typedef struct {
+  int         fd;        /* Binary maze file */
+  int         statefd;   /* Scratch file of the search state */
+  mazeparam_t param;     /* Size, start and exits of the maze */
+  int         size;      /* Side of a square tile */
+  long long   tilecols;  /* Tiles in a tile row */
+  long long   tiles;
+  int         slots;
+  tileslot_t  *slot;
+  int         *slotof;   /* Slot of each tile, -1 if not cached */
+  bitword_t   *stored;   /* Tiles having their state in the scratch file */
+  int         mru;       /* Most recently used slot */
+  int         lru;       /* Least recently used slot */
+  long long   loads;     /* Tiles read into the cache */
+  long long   writes;    /* Tiles written back to the scratch file */
+} tilestore_t;
+
+typedef struct {
+  long long tile;
+  int       cell;        /* Square within the tile */
+  int       heading;     /* Heading of arrival */
+} tilecand_t;
+
+typedef int (* solver_t) (pentti_t *, const char *, mazeparam_t *);
+
+typedef struct {
+  char     *name;       /* Command line name */
+  char     *title;      /* Heading printed before the run */
+  solver_t solver;
+  int      flags;       /* Special requests passed to solvemaze() */
+  int      classic;     /* Run when no algorithm is chosen */
+} algorithm_t;
+
+typedef struct {
+  int  files;
+  int  capacity;
+  char **name;
+} filelist_t;
+
+typedef struct {
+  algorithm_t *algorithm;
+  char        *filename;
+  mazecache_t *cache;
+  FILE        *spill;     /* Results of a job run ahead, NULL if streamed */
+  int         rv;
+  int         done;
+} job_t;
+
+typedef struct {
+  pthread_mutex_t lock;
+  int             head;   /* First job left, taken by the owner */
+  int             tail;   /* One past the last job left, stolen by others */
+} deque_t;
+
+typedef struct {
+  job_t           *job;
+  int             jobs;
+  deque_t         *deque;     /* One per thread */
+  int             threads;
+  pthread_mutex_t outlock;    /* Guards the following */
+  int             printed;    /* Jobs written to out so far */
+  FILE            *out;
+  int             rv;         /* 1 if any job failed */
+} batch_t;
+
+typedef struct {
+  batch_t *batch;
+  int     thread;
+} batch_work_t;
 
 
 
@@ -78,12 +334,15 @@ typedef int (* solver_t) (pentti_t *, char *, mazeparam_t *);
 * RETURNS       Linear index
 *
 * HISTORY       2023 01 01   JPT   First implementation
+*               2026 10 18   JPT   64-bit arithmetic
 *
 * NOTES         mazeparam is expected to be a pointer to initialized struct.
+*               The index is a long long, as a maze may have more than
+*               INT_MAX squares.
 *
 \**************************************************************************/
 
-#define LIN(row,col) ((row) * mazeparam -> cols + (col))
+#define LIN(row,col) ((long long) (row) * mazeparam -> cols + (col))
 
 
 
@@ -114,29 +373,95 @@ typedef int (* solver_t) (pentti_t *, char *, mazeparam_t *);
 
 /**************************************************************************\
 *
-* FUNCTION      goalfound
+* MACRO         PADLIN
 *
-* DESCRIPTION   Signals the goal being found next to Pentti.
+* DESCRIPTION   Converts a coordinate pair into a padded linear index
 *
-* ARGUMENTS     pentti       The maze walker object
+* ARGUMENTS     row   The row coordinate, -1 .. rows allowed
+*               col   The column coordinate, -1 .. cols allowed
 *
 * GLOBALS       -
 *
-* RETURNS       "Goal found" flag
+* RETURNS       Linear index of the padded layer
 *
-* HISTORY       2023 01 01   JPT   First implementation
+* HISTORY       2026 10 18   JPT   First implementation
 *
-* NOTES         -
+* NOTES         mazeparam is expected to be a pointer to initialized struct.
+*               A padded layer has a ring of sentinel squares around the
+*               maze, so its rows are cols + 2 squares long.
 *
 \**************************************************************************/
 
-int goalfound(pentti_t *pentti)
-{
-  return ((int) (   (pentti -> northval == 'E')
-                 || (pentti -> southval == 'E')
-                 || (pentti -> eastval  == 'E')
-                 || (pentti -> westval  == 'E')));
-}
+#define PADLIN(row,col) (((long long) (row) + 1) * (mazeparam -> cols + 2) + (col) + 1)
+
+
+
+/**************************************************************************\
+*
+* MACRO         BITWORDS, BIT_SET, BIT_TEST
+*
+* DESCRIPTION   Packed bit layer sizing, setting and testing
+*
+* ARGUMENTS     n      Number of bits in the layer
+*               bits   The bitword_t layer
+*               idx    Linear index of the bit
+*
+* GLOBALS       -
+*
+* RETURNS       BITWORDS: number of words, BIT_TEST: bit value (0 or 1)
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         One bit per maze square, 64 squares per word. No bounds
+*               checking, the index must lie within the layer.
+*
+\**************************************************************************/
+
+#define BITWORDS(n)         (((n) + 63) / 64)
+#define BIT_SET(bits,idx)   ((bits) [(idx) >> 6] |= 1ULL << ((idx) & 63))
+#define BIT_TEST(bits,idx)  ((int) (((bits) [(idx) >> 6] >> ((idx) & 63)) & 1ULL))
+
+
+
+/**************************************************************************\
+*
+* MACRO         BOARDROW
+*
+* DESCRIPTION   Locates a row of a padded bitboard
+*
+* ARGUMENTS     board   The bitboard
+*               row     The row coordinate, -1 .. rows allowed
+*
+* GLOBALS       -
+*
+* RETURNS       Pointer to the first bitword of the row
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         stride is expected to hold the padded row length in words.
+*               Each row has a zero word on both sides, and the board has
+*               a zero row above and below the maze.
+*
+\**************************************************************************/
+
+#define BOARDROW(board,row) ((board) + ((size_t) (row) + 1) * stride + 1)
+
+
+
+/**************************************************************************\
+*
+* TABLE         headingrow, headingcol
+*
+* DESCRIPTION   Row and column offsets of the folded headings
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         Heading 0 is east, 1 north, 2 west and 3 south.
+*
+\**************************************************************************/
+
+static const int headingrow [4] = { 0, -1,  0,  1};
+static const int headingcol [4] = { 1,  0, -1,  0};
 
 
 
@@ -172,938 +497,6658 @@ int outside(mazeparam_t *mazeparam, int row, int col)
 
 /**************************************************************************\
 *
-* FUNCTION      mazeval
+* FUNCTION      rle_append_row
 *
-* DESCRIPTION   Maze square content retriever.
+* DESCRIPTION   Appends a maze row to run-length encoded rows
 *
-* ARGUMENTS     maze        The maze map
-*               mazeparam   The maze parameter struct
-*               row         Row of the interrogated location
-*               col         Column of the interrogated location
+* ARGUMENTS     rle    The run-length rows [INPUT/OUTPUT]
+*               row    The squares of the row
+*               cols   Number of squares in the row
 *
 * GLOBALS       -
 *
-* RETURNS       Maze square character
+* RETURNS       Error code (0 == Success)
 *
-* HISTORY       2023 01 01   JPT   First implementation
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         A run is a stretch of equal squares within a row, stored
+*               as its starting column and its square character. Runs do
+*               not continue from a row to the next, so every row starts
+*               a run at the column 0.
 *
-* NOTES         Cells outside the maze are returned as '#'.
+*               The tables are grown by doubling. Start from a zeroed
+*               rlemaze_t and release with free_rle().
 *
 \**************************************************************************/
 
-char mazeval(char *maze, mazeparam_t *mazeparam, int row, int col)
+int rle_append_row(rlemaze_t *rle, const char *row, int cols)
 {
-  if (outside(mazeparam, row, col)) return ('#');
-  return (maze [LIN(row, col)]);
+  if (rle -> rows + 2 > rle -> rowcap) {
+    long long cap = rle -> rowcap ? 2 * rle -> rowcap : 64;
+    long long *first = (long long *) realloc(rle -> first, cap * sizeof (long long));
+    if (first == NULL) {
+      fprintf(stderr, "Cannot allocate memory for maze runs.\n");
+      return (1);
+    }
+    rle -> first = first;
+    rle -> rowcap = cap;
+  }
+  rle -> first [rle -> rows] = rle -> runs;
+  for (int c = 0; c < cols; c++) {
+    if ((c > 0) && (row [c] == row [c - 1])) continue;
+    if (rle -> runs == rle -> runcap) {
+      long long cap = rle -> runcap ? 2 * rle -> runcap : 1024;
+      int       *start = (int *) realloc(rle -> start, cap * sizeof (int));
+      char      *square = start ? (char *) realloc(rle -> square, cap) : NULL;
+      if (start) rle -> start = start;
+      if (square == NULL) {
+        fprintf(stderr, "Cannot allocate memory for maze runs.\n");
+        return (1);
+      }
+      rle -> square = square;
+      rle -> runcap = cap;
+    }
+    rle -> start [rle -> runs] = c;
+    rle -> square [rle -> runs] = row [c];
+    rle -> runs ++;
+  }
+  rle -> rows ++;
+  rle -> first [rle -> rows] = rle -> runs;
+  return (0);
 }
 
 
 
 /**************************************************************************\
 *
-* FUNCTION      update_pentti
+* FUNCTION      rle_val
 *
-* DESCRIPTION   Precalculate the surroundings
+* DESCRIPTION   Square of run-length encoded rows
 *
-* ARGUMENTS     pentti       The maze walker object
-*               maze         The maze map main layer
-*               mazeparam    The maze parameter struct
-*               row          New placement row
-*               col          New placement column
+* ARGUMENTS     rle    The run-length rows
+*               row    Row of the interrogated location
+*               col    Column of the interrogated location
 *
 * GLOBALS       -
 *
-* RETURNS       -
+* RETURNS       Maze square character
 *
-* HISTORY       2023 01 01   JPT   First implementation
+* HISTORY       2026 10 18   JPT   First implementation
 *
-* NOTES         This function does not affect Pentti's position or
-*               orientation. Use set_pentti_at() or turn_pentti() to change
-*               them.
+* NOTES         Finds the last run of the row starting at or before the
+*               column by a binary search, in O(log runs) time. The
+*               location must be inside the maze, see mazeval().
 *
 \**************************************************************************/
 
-void update_pentti(pentti_t *pentti, char *maze, mazeparam_t *mazeparam)
+char rle_val(const rlemaze_t *rle, int row, int col)
 {
-  pentti -> folded_heading = (pentti -> unfolded_heading & 0x3);
-  pentti -> idx = LIN (pentti -> row, pentti -> col);
-  pentti -> atval = mazeval(maze, mazeparam, pentti -> row, pentti -> col);
-  pentti -> northrow = pentti -> row - 1;
-  pentti -> northcol = pentti -> col;
-  pentti -> northidx = LIN (pentti -> northrow, pentti -> northcol);
-  pentti -> northval = mazeval(maze, mazeparam, pentti -> northrow, pentti -> northcol);
-  pentti -> southrow = pentti -> row + 1;
-  pentti -> southcol = pentti -> col;
-  pentti -> southidx = LIN (pentti -> southrow, pentti -> southcol);
-  pentti -> southval = mazeval(maze, mazeparam, pentti -> southrow, pentti -> southcol);
-  pentti -> eastrow  = pentti -> row;
-  pentti -> eastcol  = pentti -> col + 1;
-  pentti -> eastidx  = LIN (pentti -> eastrow, pentti -> eastcol);
-  pentti -> eastval  = mazeval(maze, mazeparam, pentti -> eastrow, pentti -> eastcol);
-  pentti -> westrow  = pentti -> row;
-  pentti -> westcol  = pentti -> col - 1;
-  pentti -> westidx  = LIN (pentti -> westrow, pentti -> westcol);
-  pentti -> westval  = mazeval(maze, mazeparam, pentti -> westrow, pentti -> westcol);
-  if (pentti -> folded_heading == 0) {
-    pentti -> aheadrow = pentti -> eastrow;
-    pentti -> aheadcol = pentti -> eastcol;
-    pentti -> aheadidx = pentti -> eastidx;
-    pentti -> aheadval = pentti -> eastval;
-    pentti -> siderow  = pentti -> southrow;
-    pentti -> sidecol  = pentti -> southcol;
-    pentti -> sideidx  = pentti -> southidx;
-    pentti -> sideval  = pentti -> southval;
-  }
-  if (pentti -> folded_heading == 1) {
-    pentti -> aheadrow = pentti -> northrow;
-    pentti -> aheadcol = pentti -> northcol;
-    pentti -> aheadidx = pentti -> northidx;
-    pentti -> aheadval = pentti -> northval;
-    pentti -> siderow  = pentti -> eastrow;
-    pentti -> sidecol  = pentti -> eastcol;
-    pentti -> sideidx  = pentti -> eastidx;
-    pentti -> sideval  = pentti -> eastval;
-  }
-  if (pentti -> folded_heading == 2) {
-    pentti -> aheadrow = pentti -> westrow;
-    pentti -> aheadcol = pentti -> westcol;
-    pentti -> aheadidx = pentti -> westidx;
-    pentti -> aheadval = pentti -> westval;
-    pentti -> siderow  = pentti -> northrow;
-    pentti -> sidecol  = pentti -> northcol;
-    pentti -> sideidx  = pentti -> northidx;
-    pentti -> sideval  = pentti -> northval;
-  }
-  if (pentti -> folded_heading == 3) {
-    pentti -> aheadrow = pentti -> southrow;
-    pentti -> aheadcol = pentti -> southcol;
-    pentti -> aheadidx = pentti -> southidx;
-    pentti -> aheadval = pentti -> southval;
-    pentti -> siderow  = pentti -> westrow;
-    pentti -> sidecol  = pentti -> westcol;
-    pentti -> sideidx  = pentti -> westidx;
-    pentti -> sideval  = pentti -> westval;
+  long long lo = rle -> first [row];
+  long long hi = rle -> first [row + 1] - 1;
+  while (lo < hi) {
+    long long mid = lo + (hi - lo + 1) / 2;
+    if (rle -> start [mid] <= col) lo = mid;
+    else hi = mid - 1;
   }
+  return (rle -> square [lo]);
 }
 
 
 
 /**************************************************************************\
 *
-* FUNCTION      set_pentti_at
+* FUNCTION      rle_row
 *
-* DESCRIPTION   Relocate to arbitrary coordinates and update
+* DESCRIPTION   Expands a row of run-length encoded rows
 *
-* ARGUMENTS     pentti       The maze walker object
-*               maze         The maze map main layer
-*               mazeparam    The maze parameter struct
-*               row          New placement row
-*               col          New placement column
+* ARGUMENTS     rle    The run-length rows
+*               row    The row to expand
+*               buf    The squares of the row [OUTPUT]
+*               cols   Number of squares in the row
 *
 * GLOBALS       -
 *
 * RETURNS       -
 *
-* HISTORY       2023 01 01   JPT   First implementation
+* HISTORY       2026 10 18   JPT   First implementation
 *
 * NOTES         -
 *
 \**************************************************************************/
 
-void set_pentti_at(pentti_t *pentti, char *maze, mazeparam_t *mazeparam,
-                   int row, int col)
+void rle_row(const rlemaze_t *rle, int row, char *buf, int cols)
 {
-  pentti -> row = row;
-  pentti -> col = col;
-  update_pentti(pentti, maze, mazeparam);
-  pentti -> steps ++;
+  long long last = rle -> first [row + 1];
+  for (long long i = rle -> first [row]; i < last; i++) {
+    int end = (i + 1 < last) ? rle -> start [i + 1] : cols;
+    memset(buf + rle -> start [i], rle -> square [i], end - rle -> start [i]);
+  }
 }
 
 
 
 /**************************************************************************\
 *
-* FUNCTION      turn_pentti
+* FUNCTION      free_rle
 *
-* DESCRIPTION   Change the orientation
+* DESCRIPTION   Releases run-length encoded rows
 *
-* ARGUMENTS     pentti       The maze walker object
-*               maze         The maze map main layer
-*               mazeparam    The maze parameter struct
-*               turn         Addition to the orientation in full quadrants
+* ARGUMENTS     rle    The run-length rows
 *
 * GLOBALS       -
 *
 * RETURNS       -
 *
-* HISTORY       2023 01 01   JPT   First implementation
-*
-* NOTES         unfolded heading runs from -MAX_INT to MAX_INT while
-*               folded_heading is folded to [0 .. 3].
+* HISTORY       2026 10 18   JPT   First implementation
 *
-*               Turning does not count as a step. Do the step separately
-*               when necessary.
+* NOTES         Leaves the rows empty, ready for reuse.
 *
 \**************************************************************************/
 
-void turn_pentti(pentti_t *pentti, char *maze, mazeparam_t *mazeparam,
-                 int turn) {
-  pentti -> unfolded_heading += turn;
-  update_pentti(pentti, maze, mazeparam);
+void free_rle(rlemaze_t *rle)
+{
+  free(rle -> first);
+  free(rle -> start);
+  free(rle -> square);
+  memset(rle, 0, sizeof (rlemaze_t));
 }
 
 
 
 /**************************************************************************\
 *
-* FUNCTION      exclude
+* FUNCTION      squareval
 *
-* DESCRIPTION   Sets exclusion data at given coordinates
+* DESCRIPTION   Maze square content retriever for a known location
 *
-* ARGUMENTS     mazeparam    The maze parameter struct
-*               exclusion    Exclusion data map layer
-*               row          Inquired row
-*               col          Inquired column
+* ARGUMENTS     maze        The maze map
+*               mazeparam   The maze parameter struct
+*               row         Row of the interrogated location
+*               col         Column of the interrogated location
+*               idx         Linear index of the interrogated location
 *
 * GLOBALS       -
 *
-* RETURNS       -
+* RETURNS       Maze square character
 *
-* HISTORY       2023 01 01   JPT   First implementation
+* HISTORY       2026 10 18   JPT   Separated from mazeval()
 *
-* NOTES         -
+* NOTES         The location must be inside the maze, and idx must match
+*               row and col. Use mazeval() when not known.
 *
 \**************************************************************************/
 
-void exclude (mazeparam_t *mazeparam, int *exclusion, int row, int col)
+char squareval(const char *maze, mazeparam_t *mazeparam, int row, int col,
+               long long idx)
 {
-  int idx = LIN(row, col);
-  if (! outside(mazeparam, row, col)) exclusion [idx] = 1;
-  else fprintf(stderr, "Exclusion pointing outside maze!\n");
+  if (mazeparam -> overlay && mazeparam -> overlay [idx]) {
+    return (mazeparam -> overlay [idx]);
+  }
+  if (mazeparam -> rle) return (rle_val(mazeparam -> rle, row, col));
+  return (maze [idx]);
 }
 
 
 
 /**************************************************************************\
 *
-* FUNCTION      exclusion_at
+* FUNCTION      mazeval
 *
-* DESCRIPTION   Retrieves exclusion data at given coordinates
+* DESCRIPTION   Maze square content retriever.
 *
-* ARGUMENTS     mazeparam    The maze parameter struct
-*               exclusion    Exclusion data map layer
-*               row          Inquired row
-*               col          Inquired column
+* ARGUMENTS     maze        The maze map
+*               mazeparam   The maze parameter struct
+*               row         Row of the interrogated location
+*               col         Column of the interrogated location
 *
 * GLOBALS       -
 *
-* RETURNS       Exclusion state at a maze square
+* RETURNS       Maze square character
 *
 * HISTORY       2023 01 01   JPT   First implementation
+*               2026 10 18   JPT   Markers from mazeparam -> overlay
+*               2026 10 18   JPT   64-bit index
+*               2026 10 18   JPT   Run-length rows
+*               2026 10 18   JPT   Squares by squareval()
 *
-* NOTES         -
+* NOTES         Cells outside the maze are returned as '#'. A marker of
+*               the running solver hides the square under it, as when the
+*               markers were written into the maze itself. The wall
+*               follower depends on this: its trail may cut through a
+*               wall, which stays open afterwards.
+*
+*               With mazeparam -> rle set, the squares are read from the
+*               run-length rows and the maze map is not used.
 *
 \**************************************************************************/
 
-int exclusion_at(mazeparam_t *mazeparam, int *exclusion, int row, int col)
+char mazeval(const char *maze, mazeparam_t *mazeparam, int row, int col)
 {
-  int idx = LIN(row, col);
-  if (outside(mazeparam, row, col)) return (1);
-  return (exclusion [idx]);
+  if (outside(mazeparam, row, col)) return ('#');
+  return (squareval(maze, mazeparam, row, col, LIN(row, col)));
 }
 
 
 
 /**************************************************************************\
 *
-* FUNCTION      get_parent_data
+* FUNCTION      maze_row
 *
-* DESCRIPTION   Retrieves parent coordinates from a maze map parallel layer
+* DESCRIPTION   Maze row retriever
 *
-* ARGUMENTS     parent_data  Parallel map layer for coordinate pairs
-*               mazeparam    The maze parameter struct
-*               row          Inquired row
-*               col          Inquired column
-*               parentrow    Parent row value
-*               parentcol    Parent column value
+* ARGUMENTS     maze        The maze map
+*               mazeparam   The maze parameter struct
+*               row         The row to retrieve
+*               buf         Room for the squares of a row
 *
 * GLOBALS       -
 *
-* RETURNS       -
+* RETURNS       The squares of the row
 *
-* HISTORY       2023 01 01   JPT   First implementation
+* HISTORY       2026 10 18   JPT   First implementation
 *
-* NOTES         Used to find traversal step descendancy.
+* NOTES         Returns the row of the maze map in place, or expands the
+*               run-length row into buf if mazeparam -> rle is set. The
+*               markers of the overlay are not applied.
 *
 \**************************************************************************/
 
-void get_parent_data (parent_data_t *parent_data, mazeparam_t *mazeparam,
-                      int row, int col, int *parentrow, int *parentcol)
+const char *maze_row(const char *maze, mazeparam_t *mazeparam, int row, char *buf)
 {
-  int idx = LIN(row, col);
-  *parentrow = parent_data [idx].row;
-  *parentcol = parent_data [idx].col;
+  if (mazeparam -> rle == NULL) return (maze + LIN(row, 0));
+  rle_row(mazeparam -> rle, row, buf, mazeparam -> cols);
+  return (buf);
 }
 
 
 
 /**************************************************************************\
 *
-* FUNCTION      set_parent_data
+* FUNCTION      walkable
 *
-* DESCRIPTION   Sets parent coordinates to a maze square of a parallel layer
+* DESCRIPTION   Tells whether a square can be stepped on
 *
-* ARGUMENTS     parent_data  Parallel map layer for coordinate pairs
-*               mazeparam    The maze parameter struct
-*               targetrow    Receiving row
-*               targetcol    Receiving column
-*               row          Parent row value
-*               col          Parent column value
+* ARGUMENTS     maze        The maze map
+*               mazeparam   The maze parameter struct
+*               row         Inquired row
+*               col         Inquired column
 *
 * GLOBALS       -
 *
-* RETURNS       -
+* RETURNS       1 for a free square, 0 for a wall, an exit or the outside
 *
-* HISTORY       2023 01 01   JPT   First implementation
+* HISTORY       2026 10 18   JPT   First implementation
+*               2026 10 18   JPT   Wall mask layer
 *
-* NOTES         Used to show traversal step descendancy.
+* NOTES         Exploration markers count as free squares.
+*
+*               With the wall mask layer of mazeinit(), a single load for
+*               squares inside the maze or in its sentinel ring. Without
+*               it, the square is read by mazeval().
 *
 \**************************************************************************/
 
-void set_parent_data (parent_data_t *parent_data, mazeparam_t *mazeparam,
-                      int targetrow, int targetcol, int row, int col)
+int walkable(const char *maze, mazeparam_t *mazeparam, int row, int col)
 {
-  int idx = LIN(targetrow, targetcol);
-  parent_data [idx].row = row;
-  parent_data [idx].col = col;
+  char ch;
+  if (mazeparam -> cellmask) {
+    return ((int) ((mazeparam -> cellmask [PADLIN(row, col)] & CELL_WALKABLE) != 0));
+  }
+  ch = mazeval(maze, mazeparam, row, col);
+  return ((int) ((ch != '#') && (ch != 'E')));
 }
 
 
 
-/************************************************************************** \
+/**************************************************************************\
 *
-* FUNCTION      readln_stripped
+* FUNCTION      nextto_exit
 *
-* DESCRIPTION   Read a maze row with unknown end characters
+* DESCRIPTION   Tells whether a square is a goal square next to an exit
 *
-* ARGUMENTS     f     Read file pointer
-*               buf   Line buffer
-*               len   Line length [OUTPUT]
+* ARGUMENTS     maze        The maze map
+*               mazeparam   The maze parameter struct
+*               row         Inquired row
+*               col         Inquired column
 *
 * GLOBALS       -
 *
-* RETURNS       -
+* RETURNS       1 for a goal square, 0 otherwise
 *
-* HISTORY       2023 01 01   JPT   First implementation
+* HISTORY       2026 10 18   JPT   First implementation
+*               2026 10 18   JPT   Wall mask layer
 *
-* NOTES         Removes irrelevant characters at the end of the line.
+* NOTES         The same test as goalfound() without a walker object. A
+*               single load with the wall mask layer. Only squares inside
+*               the maze are meaningful; the sentinel ring reads 0.
 *
 \**************************************************************************/
 
-void readln_stripped(FILE *f, char *buf, int *len)
+int nextto_exit(const char *maze, mazeparam_t *mazeparam, int row, int col)
 {
-  *len = 0;
-  buf [0] = '\0';
-  (void) fgets (buf, MAX_ALLOWED_ROWLENGTH + 3, f);
-  *len = strlen(buf);
-  if (*len == 0) {
-    buf [0] = '\0';
-    return;
+  if (mazeparam -> cellmask) {
+    return ((int) ((mazeparam -> cellmask [PADLIN(row, col)] & CELL_NEXTTO_EXIT) != 0));
   }
-  for (int i = *len - 1; i >= 0; i--) {
-    if (! isgraph(buf [i])) {
-      buf [i] = '\0';
-      (*len)--;
+  for (int h = 0; h < 4; h++) {
+    if (mazeval(maze, mazeparam, row + headingrow [h], col + headingcol [h]) == 'E') {
+      return (1);
     }
-    else break;
   }
+  return (0);
 }
 
 
 
-/************************************************************************** \
+/**************************************************************************\
 *
-* FUNCTION      measuremaze
+* FUNCTION      open_mask
 *
-* DESCRIPTION   Maze size measurement
+* DESCRIPTION   Tells which neighbours of a square can be stepped on
 *
-* ARGUMENTS     filename    The name of the text file containing a maze
+* ARGUMENTS     maze        The maze map
 *               mazeparam   The maze parameter struct
+*               row         Inquired row
+*               col         Inquired column
 *
 * GLOBALS       -
 *
-* RETURNS       Error code (0 == Success)
-*
-* HISTORY       2023 01 01   JPT   First implementation
+* RETURNS       Bit h set for a walkable neighbour of the heading h
 *
-* NOTES         Finds maze size for space allocation.
+* HISTORY       2026 10 18   JPT   First implementation
 *
-*               The outer wall of the maze is presumed to be a rectangle
-*               to disambiguate the allowed maze area.
+* NOTES         A single load with the wall mask layer, four walkable()
+*               calls without it. The square must be inside the maze.
 *
 \**************************************************************************/
 
-int measuremaze(char *filename, mazeparam_t *mazeparam)
+int open_mask(const char *maze, mazeparam_t *mazeparam, int row, int col)
 {
-  FILE *f  = NULL;
-  int  len = 0;
-  char buf [MAX_ALLOWED_ROWLENGTH + 3];   /* Allow \r\n\0 at the end */
-  int  rv = 0;
-  f = fopen (filename, "r");
-  if (f == NULL)
-  {
-    perror("Cannot open input file");
-    return (1);
+  int open = 0;
+  if (mazeparam -> cellmask) {
+    return (mazeparam -> cellmask [PADLIN(row, col)] & 0x0f);
   }
-  mazeparam -> rows = 0;
-  mazeparam -> cols = 0;
-  for (len = 0; 1; len++) {
-    char ch = getc (f);
-    if (! isgraph(ch)) break;
-    if (len > MAX_ALLOWED_ROWLENGTH) {
-      fprintf (stderr,
-               "Maze too wide, maximum allowed width is %d\n",
-               MAX_ALLOWED_ROWLENGTH);
-      return (1);
-    }
+  for (int h = 0; h < 4; h++) {
+    open |= walkable(maze, mazeparam, row + headingrow [h], col + headingcol [h]) << h;
   }
-  if (len == 0)  {
-    fprintf(stderr, "The first maze row was empty\n");
+  return (open);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      set_pentti_at
+*
+* DESCRIPTION   Relocate to arbitrary coordinates
+*
+* ARGUMENTS     pentti       The maze walker object
+*               maze         The maze map main layer
+*               mazeparam    The maze parameter struct
+*               row          New placement row
+*               col          New placement column
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2023 01 01   JPT   First implementation
+*               2026 10 18   JPT   Index offsets instead of neighbours
+*
+* NOTES         The surroundings are no longer precalculated. Only the
+*               linear index and the index offsets of the four headings
+*               are set here, and the neighbours are looked up when asked
+*               for, see pentti_look(). Moving ahead is cheaper with
+*               step_pentti().
+*
+\**************************************************************************/
+
+void set_pentti_at(pentti_t *pentti, const char *maze, mazeparam_t *mazeparam,
+                   int row, int col)
+{
+  pentti -> row = row;
+  pentti -> col = col;
+  pentti -> idx = LIN(row, col);
+  for (int h = 0; h < 4; h++) {
+    pentti -> offset [h] = LIN(headingrow [h], headingcol [h]);
+  }
+  pentti -> folded_heading = (pentti -> unfolded_heading & 0x3);
+  pentti -> steps ++;
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      step_pentti
+*
+* DESCRIPTION   Move one square ahead
+*
+* ARGUMENTS     pentti       The maze walker object
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         As set_pentti_at() to the square ahead, but by the index
+*               offset of the heading. Pentti must have been placed by
+*               set_pentti_at() first.
+*
+\**************************************************************************/
+
+void step_pentti(pentti_t *pentti)
+{
+  int h = pentti -> folded_heading;
+  pentti -> row += headingrow [h];
+  pentti -> col += headingcol [h];
+  pentti -> idx += pentti -> offset [h];
+  pentti -> steps ++;
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      turn_pentti
+*
+* DESCRIPTION   Change the orientation
+*
+* ARGUMENTS     pentti       The maze walker object
+*               turn         Addition to the orientation in full quadrants
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2023 01 01   JPT   First implementation
+*               2026 10 18   JPT   No neighbour update
+*
+* NOTES         unfolded heading runs from -MAX_INT to MAX_INT while
+*               folded_heading is folded to [0 .. 3].
+*
+*               Turning does not count as a step. Do the step separately
+*               when necessary.
+*
+\**************************************************************************/
+
+void turn_pentti(pentti_t *pentti, int turn)
+{
+  pentti -> unfolded_heading += turn;
+  pentti -> folded_heading = (pentti -> unfolded_heading & 0x3);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      pentti_look
+*
+* DESCRIPTION   Neighbour square content retriever
+*
+* ARGUMENTS     pentti       The maze walker object
+*               maze         The maze map main layer
+*               mazeparam    The maze parameter struct
+*               heading      Heading of the neighbour, folded here
+*
+* GLOBALS       -
+*
+* RETURNS       Maze square character
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         Same as mazeval() of the neighbour, but indexed by the
+*               offset of the heading. The square ahead is the heading
+*               folded_heading and the side square folded_heading + 3,
+*               on the right hand.
+*
+\**************************************************************************/
+
+char pentti_look(pentti_t *pentti, const char *maze, mazeparam_t *mazeparam,
+                 int heading)
+{
+  int h = heading & 0x3;
+  int row = pentti -> row + headingrow [h];
+  int col = pentti -> col + headingcol [h];
+  if (outside(mazeparam, row, col)) return ('#');
+  return (squareval(maze, mazeparam, row, col, pentti -> idx + pentti -> offset [h]));
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      pentti_open
+*
+* DESCRIPTION   Tells whether Pentti may step to a neighbour
+*
+* ARGUMENTS     pentti       The maze walker object
+*               maze         The maze map main layer
+*               mazeparam    The maze parameter struct
+*               heading      Heading of the neighbour, folded here
+*
+* GLOBALS       -
+*
+* RETURNS       1 for a walkable or marked neighbour, 0 otherwise
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         A marker of the overlay opens a wall, as in mazeval(): the
+*               trail of the wall follower may cut through a wall. With
+*               the wall mask layer, the overlay is read only for the
+*               neighbours the mask reports closed.
+*
+\**************************************************************************/
+
+int pentti_open(pentti_t *pentti, const char *maze, mazeparam_t *mazeparam,
+                int heading)
+{
+  int  h = heading & 0x3;
+  char ch;
+  if (mazeparam -> cellmask) {
+    if ((mazeparam -> cellmask [PADLIN(pentti -> row, pentti -> col)] >> h) & 1) {
+      return (1);
+    }
+    if (   (mazeparam -> overlay == NULL)
+        || outside(mazeparam, pentti -> row + headingrow [h],
+                   pentti -> col + headingcol [h])) {
+      return (0);
+    }
+    return ((int) (mazeparam -> overlay [pentti -> idx + pentti -> offset [h]] != 0));
+  }
+  ch = pentti_look(pentti, maze, mazeparam, h);
+  return ((int) ((ch != '#') && (ch != 'E')));
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      goalfound
+*
+* DESCRIPTION   Signals the goal being found next to Pentti.
+*
+* ARGUMENTS     pentti       The maze walker object
+*               maze         The maze map main layer
+*               mazeparam    The maze parameter struct
+*
+* GLOBALS       -
+*
+* RETURNS       "Goal found" flag
+*
+* HISTORY       2023 01 01   JPT   First implementation
+*               2026 10 18   JPT   Neighbours looked up by pentti_look()
+*               2026 10 18   JPT   By nextto_exit()
+*
+* NOTES         -
+*
+\**************************************************************************/
+
+int goalfound(pentti_t *pentti, const char *maze, mazeparam_t *mazeparam)
+{
+  return (nextto_exit(maze, mazeparam, pentti -> row, pentti -> col));
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      exclude
+*
+* DESCRIPTION   Sets exclusion data at given coordinates
+*
+* ARGUMENTS     mazeparam    The maze parameter struct
+*               exclusion    Exclusion data map layer
+*               row          Inquired row
+*               col          Inquired column
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2023 01 01   JPT   First implementation
+*               2026 10 18   JPT   Packed bit layer
+*
+* NOTES         The layer holds one bit per square. Hot loops with a
+*               known in-maze index use BIT_SET() directly.
+*
+\**************************************************************************/
+
+void exclude (mazeparam_t *mazeparam, bitword_t *exclusion, int row, int col)
+{
+  int idx = LIN(row, col);
+  if (! outside(mazeparam, row, col)) BIT_SET(exclusion, idx);
+  else fprintf(stderr, "Exclusion pointing outside maze!\n");
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      exclusion_at
+*
+* DESCRIPTION   Retrieves exclusion data at given coordinates
+*
+* ARGUMENTS     mazeparam    The maze parameter struct
+*               exclusion    Exclusion data map layer
+*               row          Inquired row
+*               col          Inquired column
+*
+* GLOBALS       -
+*
+* RETURNS       Exclusion state at a maze square
+*
+* HISTORY       2023 01 01   JPT   First implementation
+*               2026 10 18   JPT   Packed bit layer
+*
+* NOTES         Squares outside the maze are excluded. Hot loops with a
+*               known in-maze index use BIT_TEST() directly.
+*
+\**************************************************************************/
+
+int exclusion_at(mazeparam_t *mazeparam, bitword_t *exclusion, int row, int col)
+{
+  int idx = LIN(row, col);
+  if (outside(mazeparam, row, col)) return (1);
+  return (BIT_TEST(exclusion, idx));
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      init_parent_data
+*
+* DESCRIPTION   Allocates an empty parent layer
+*
+* ARGUMENTS     parent_data  Parallel map layer for parent headings [OUTPUT]
+*               mazesize     Number of maze squares
+*
+* GLOBALS       -
+*
+* RETURNS       Error code (0 == Success)
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         IMPORTANT: Allocates heap memory! Release it with
+*               free_parent_data().
+*
+*               A parent is always one of the four neighbours, so it is
+*               stored as a 2-bit heading, plus one bit telling whether
+*               the square has a parent at all: 3 bits instead of 64.
+*
+\**************************************************************************/
+
+int init_parent_data (parent_data_t *parent_data, int mazesize)
+{
+  parent_data -> root  = -1;
+  parent_data -> dir   = (unsigned char *) calloc((mazesize + 3) / 4, 1);
+  parent_data -> known =
+    (bitword_t *) calloc(BITWORDS(mazesize), sizeof (bitword_t));
+  if ((parent_data -> dir == NULL) || (parent_data -> known == NULL)) {
+    free(parent_data -> dir);
+    free(parent_data -> known);
+    parent_data -> dir   = NULL;
+    parent_data -> known = NULL;
+    return (1);
+  }
+  return (0);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      free_parent_data
+*
+* DESCRIPTION   Releases a parent layer
+*
+* ARGUMENTS     parent_data  Parallel map layer for parent headings
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         -
+*
+\**************************************************************************/
+
+void free_parent_data (parent_data_t *parent_data)
+{
+  free(parent_data -> dir);
+  free(parent_data -> known);
+  parent_data -> dir   = NULL;
+  parent_data -> known = NULL;
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      get_parent_data
+*
+* DESCRIPTION   Retrieves parent coordinates from a maze map parallel layer
+*
+* ARGUMENTS     parent_data  Parallel map layer for parent headings
+*               mazeparam    The maze parameter struct
+*               row          Inquired row
+*               col          Inquired column
+*               parentrow    Parent row value
+*               parentcol    Parent column value
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2023 01 01   JPT   First implementation
+*               2026 10 18   JPT   Decoding of 2-bit headings
+*
+* NOTES         Used to find traversal step descendancy.
+*
+*               A square without a parent returns -1, -1. The root square
+*               returns its own coordinates.
+*
+\**************************************************************************/
+
+void get_parent_data (parent_data_t *parent_data, mazeparam_t *mazeparam,
+                      int row, int col, int *parentrow, int *parentcol)
+{
+  int idx = LIN(row, col);
+  int heading;
+  if (! BIT_TEST(parent_data -> known, idx)) {
+    *parentrow = -1;
+    *parentcol = -1;
+    return;
+  }
+  if (idx == parent_data -> root) {
+    *parentrow = row;
+    *parentcol = col;
+    return;
+  }
+  heading = (parent_data -> dir [idx >> 2] >> ((idx & 3) << 1)) & 0x3;
+  *parentrow = row + headingrow [heading];
+  *parentcol = col + headingcol [heading];
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      set_parent_data
+*
+* DESCRIPTION   Sets parent coordinates to a maze square of a parallel layer
+*
+* ARGUMENTS     parent_data  Parallel map layer for parent headings
+*               mazeparam    The maze parameter struct
+*               targetrow    Receiving row
+*               targetcol    Receiving column
+*               row          Parent row value
+*               col          Parent column value
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2023 01 01   JPT   First implementation
+*               2026 10 18   JPT   Encoding as 2-bit headings
+*
+* NOTES         Used to show traversal step descendancy.
+*
+*               The parent must be a neighbour of the target, or the
+*               target itself, making the target the root.
+*
+\**************************************************************************/
+
+void set_parent_data (parent_data_t *parent_data, mazeparam_t *mazeparam,
+                      int targetrow, int targetcol, int row, int col)
+{
+  int idx = LIN(targetrow, targetcol);
+  int heading;
+  if ((row == targetrow) && (col == targetcol)) {
+    parent_data -> root = idx;
+    BIT_SET(parent_data -> known, idx);
+    return;
+  }
+  for (heading = 0; heading < 4; heading++) {
+    if (   (targetrow + headingrow [heading] == row)
+        && (targetcol + headingcol [heading] == col)) break;
+  }
+  if (heading == 4) {
+    fprintf(stderr, "Parent is not a neighbour!\n");
+    return;
+  }
+  parent_data -> dir [idx >> 2] &= (unsigned char) ~(0x3 << ((idx & 3) << 1));
+  parent_data -> dir [idx >> 2] |= (unsigned char) (heading << ((idx & 3) << 1));
+  BIT_SET(parent_data -> known, idx);
+}
+
+
+
+/************************************************************************** \
+*
+* FUNCTION      readln_stripped
+*
+* DESCRIPTION   Read a maze row with unknown end characters
+*
+* ARGUMENTS     f     Read file pointer
+*               buf   Line buffer, grown as needed [INPUT/OUTPUT]
+*               size  Allocated size of the line buffer [INPUT/OUTPUT]
+*               len   Line length [OUTPUT]
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2023 01 01   JPT   First implementation
+*               2026 10 18   JPT   Rows of any length
+*
+* NOTES         Removes irrelevant characters at the end of the line.
+*
+*               The buffer is reallocated by getline(), start with NULL
+*               and 0 and free it after the last row.
+*
+\**************************************************************************/
+
+void readln_stripped(FILE *f, char **buf, size_t *size, int *len)
+{
+  ssize_t got = getline(buf, size, f);
+  *len = 0;
+  if ((got <= 0) || (got > INT_MAX)) {
+    if (*buf) (*buf) [0] = '\0';
+    return;
+  }
+  *len = (int) got;
+  for (int i = *len - 1; i >= 0; i--) {
+    if (! isgraph((*buf) [i])) {
+      (*buf) [i] = '\0';
+      (*len)--;
+    }
+    else break;
+  }
+}
+
+
+
+/************************************************************************** \
+*
+* FUNCTION      measuremaze
+*
+* DESCRIPTION   Maze size measurement
+*
+* ARGUMENTS     filename    The name of the text file containing a maze
+*               mazeparam   The maze parameter struct
+*
+* GLOBALS       -
+*
+* RETURNS       Error code (0 == Success)
+*
+* HISTORY       2023 01 01   JPT   First implementation
+*               2026 10 18   JPT   No width limit
+*
+* NOTES         Finds maze size for space allocation.
+*
+*               The outer wall of the maze is presumed to be a rectangle
+*               to disambiguate the allowed maze area.
+*
+\**************************************************************************/
+
+int measuremaze(char *filename, mazeparam_t *mazeparam)
+{
+  FILE   *f  = NULL;
+  int    len = 0;
+  char   *buf = NULL;
+  size_t size = 0;
+  f = fopen (filename, "r");
+  if (f == NULL)
+  {
+    perror("Cannot open input file");
+    return (1);
+  }
+  mazeparam -> rows = 0;
+  mazeparam -> cols = 0;
+  for (len = 0; 1; len++) {
+    int ch = getc (f);
+    if ((ch == EOF) || ! isgraph(ch)) break;
+    if (len == INT_MAX) {
+      fprintf (stderr, "Maze too wide, maximum allowed width is %d\n", INT_MAX);
+      fclose(f);
+      return (1);
+    }
+  }
+  if (len == 0)  {
+    fprintf(stderr, "The first maze row was empty\n");
+    fclose(f);
+    return (1);
+  }
+  mazeparam -> cols = len;
+  mazeparam -> rows ++;
+  while (! feof(f)) {
+    readln_stripped(f, &buf, &size, &len);
+    if (len == 0) break;
+    if (len != mazeparam -> cols) {
+      fprintf(stderr, "Uneven row lengths in maze\n");
+      free(buf);
+      fclose(f);
+      return (1);
+    }
+    mazeparam -> rows ++;
+  }
+  free(buf);
+  fclose(f);
+  return (0);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      loadmaze
+*
+* DESCRIPTION   Maze input loader
+*
+* ARGUMENTS     filename    The name of the text file containing a maze
+*               maze        The maze map [OUTPUT]
+*               mazeparam   The maze parameter struct
+*
+* GLOBALS       -
+*
+* RETURNS       Error code (0 == Success)
+*
+* HISTORY       2023 01 01   JPT   First implementation
+*               2026 10 18   JPT   Rows of any length
+*
+* NOTES         Expects a sanity-checked maze!
+*
+*               IMPORTANT: Allocates heap memory!
+*
+\**************************************************************************/
+
+int loadmaze(char *filename, char **maze, mazeparam_t *mazeparam)
+{
+  FILE   *f = NULL;
+  char   *buf = NULL;
+  size_t size = 0;
+  f = fopen(filename, "r");
+  if (f == NULL)
+  {
+    perror("Cannot open input file "
+           "(Previous open succeeded? Error in code?)");
+    return (1);
+  }
+  *maze = (char *) malloc((size_t) mazeparam -> cols * mazeparam -> rows);
+  if (*maze == NULL) {
+    fprintf(stderr, "Cannot allocate memory for maze.\n");
     fclose(f);
     return (1);
   }
-  mazeparam -> cols = len;
-  mazeparam -> rows ++;
-  while (! feof(f)) {
-    readln_stripped(f, buf, &len);
-    if (len == 0) break;
-    if (len != mazeparam -> cols) {
-      fprintf(stderr, "Uneven row lengths in maze\n");
-      fclose(f);
+  for (int r = 0 ; r < mazeparam -> rows ; r++) {
+    int len = 0;
+    (void) readln_stripped(f, &buf, &size, &len);
+    memcpy(*(maze) + (size_t) r * mazeparam -> cols, buf, mazeparam -> cols);
+  }
+  free(buf);
+  fclose(f);
+  return (0);
+}
+
+
+    
+/**************************************************************************\
+*
+* FUNCTION      endpoints
+*
+* DESCRIPTION   Maze path endpoint examination
+*
+* ARGUMENTS     maze        The maze map [OUTPUT]
+*               mazeparam   The maze parameter struct
+*
+* GLOBALS       -
+*
+* RETURNS       Error code (0 == Success)
+*
+* HISTORY       2023 01 01   JPT   First implementation
+*
+* NOTES         Expects a correctly initialized mazeparam struct.
+*
+\**************************************************************************/
+
+int endpoints (char *maze, mazeparam_t *mazeparam)
+{
+  mazeparam -> exits = 0;
+  mazeparam -> startcategory = START_EDGE;
+  for (int row = 0; row < mazeparam -> rows; row++) {
+    for (int col = 0; col < mazeparam -> cols; col++) {
+      char ch = mazeval(maze, mazeparam, row, col);
+      if (ch == '^') {
+        mazeparam -> startrow = row;
+        mazeparam -> startcol = col;
+        if (   (row > 0) && (row < mazeparam -> rows - 1)
+            && (col > 0) && (col < mazeparam -> cols - 1)) {
+          mazeparam -> startcategory = START_INSIDE;
+        }
+      }
+      if (ch == 'E') {
+        if (mazeparam -> exits == MAX_EXITS + 1) {
+          fprintf(stderr, "Maximum number of exits (%d) exceeded.\n", MAX_EXITS);
+          free(maze);
+          return (1);
+        }
+        mazeparam -> exitrow [mazeparam -> exits] = row;
+        mazeparam -> exitcol [mazeparam -> exits] = col;
+        (mazeparam -> exits) ++;
+      }
+    }
+  }
+  return (0);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      next_linemark
+*
+* DESCRIPTION   Finds the next newline, start or exit character
+*
+* ARGUMENTS     p           Start of the scanned text
+*               end         End of the scanned text
+*
+* GLOBALS       -
+*
+* RETURNS       Pointer to the first '\n', '^' or 'E', end if none
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         Compares 32 (AVX2) or 16 (SSE2) characters at a time
+*               against all three characters. The tail is scanned one
+*               character at a time.
+*
+\**************************************************************************/
+
+const char *next_linemark(const char *p, const char *end)
+{
+#if defined(__AVX2__)
+  const __m256i nl = _mm256_set1_epi8('\n');
+  const __m256i st = _mm256_set1_epi8('^');
+  const __m256i ex = _mm256_set1_epi8('E');
+  for (; end - p >= 32; p += 32) {
+    __m256i v = _mm256_loadu_si256((__m256i *) p);
+    __m256i m = _mm256_or_si256(_mm256_cmpeq_epi8(v, nl),
+                                _mm256_cmpeq_epi8(v, st));
+    unsigned int mask =
+      (unsigned int) _mm256_movemask_epi8(_mm256_or_si256(m, _mm256_cmpeq_epi8(v, ex)));
+    if (mask) return (p + __builtin_ctz(mask));
+  }
+#elif defined(__SSE2__)
+  const __m128i nl = _mm_set1_epi8('\n');
+  const __m128i st = _mm_set1_epi8('^');
+  const __m128i ex = _mm_set1_epi8('E');
+  for (; end - p >= 16; p += 16) {
+    __m128i v = _mm_loadu_si128((__m128i *) p);
+    __m128i m = _mm_or_si128(_mm_cmpeq_epi8(v, nl), _mm_cmpeq_epi8(v, st));
+    unsigned int mask =
+      (unsigned int) _mm_movemask_epi8(_mm_or_si128(m, _mm_cmpeq_epi8(v, ex)));
+    if (mask) return (p + __builtin_ctz(mask));
+  }
+#endif
+  while ((p < end) && (*p != '\n') && (*p != '^') && (*p != 'E')) p++;
+  return (p);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      put_u32
+*
+* DESCRIPTION   Little-endian 32-bit field writer
+*
+* ARGUMENTS     p       Field position in the header
+*               value   Value to store
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The binary maze header is byte order independent.
+*
+\**************************************************************************/
+
+void put_u32(unsigned char *p, unsigned int value)
+{
+  for (int i = 0; i < 4; i++) p [i] = (unsigned char) (value >> (8 * i));
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      get_u32
+*
+* DESCRIPTION   Little-endian 32-bit field reader
+*
+* ARGUMENTS     p       Field position in the header
+*
+* GLOBALS       -
+*
+* RETURNS       The stored value
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         -
+*
+\**************************************************************************/
+
+unsigned int get_u32(const unsigned char *p)
+{
+  return (  (unsigned int) p [0]         | ((unsigned int) p [1] << 8)
+          | ((unsigned int) p [2] << 16) | ((unsigned int) p [3] << 24));
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      packmaze
+*
+* DESCRIPTION   Binary maze writer
+*
+* ARGUMENTS     maze        The maze map
+*               mazeparam   The maze parameter struct
+*               f           Destination file
+*
+* GLOBALS       -
+*
+* RETURNS       Error code (0 == Success)
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The file starts with a MAZEBIN_HEADER byte header:
+*
+*                 0   "MAZB"
+*                 4   format version, MAZEBIN_VERSION
+*                 8   rows, cols
+*                16   start row, start column
+*                24   number of exits
+*                28   MAX_EXITS exit rows, MAX_EXITS exit columns
+*
+*               as little-endian 32-bit fields, the rest being zero. The
+*               wall plane follows, one bit per square in row order, the
+*               lowest bit of a byte first, 1 for a wall. The start and
+*               exits are not walls. Other squares than '#', ' ', '^' and
+*               'E' cannot be stored.
+*
+\**************************************************************************/
+
+int packmaze(const char *maze, mazeparam_t *mazeparam, FILE *f)
+{
+  unsigned char header [MAZEBIN_HEADER] = {0};
+  unsigned char *plane;
+  long long     mazesize = (long long) mazeparam -> rows * mazeparam -> cols;
+  size_t        planesize = (size_t) ((mazesize + 7) / 8);
+  memcpy(header, MAZEBIN_MAGIC, 4);
+  put_u32(header + 4, MAZEBIN_VERSION);
+  put_u32(header + 8, mazeparam -> rows);
+  put_u32(header + 12, mazeparam -> cols);
+  put_u32(header + 16, mazeparam -> startrow);
+  put_u32(header + 20, mazeparam -> startcol);
+  put_u32(header + 24, mazeparam -> exits);
+  for (int e = 0; e < mazeparam -> exits; e++) {
+    put_u32(header + 28 + 4 * e, mazeparam -> exitrow [e]);
+    put_u32(header + 28 + 4 * (MAX_EXITS + e), mazeparam -> exitcol [e]);
+  }
+  plane = (unsigned char *) calloc(planesize, 1);
+  if (plane == NULL) {
+    fprintf(stderr, "Cannot allocate memory for wall plane.\n");
+    return (1);
+  }
+  for (long long idx = 0; idx < mazesize; idx++) {
+    if (maze [idx] == '#') plane [idx >> 3] |= (unsigned char) (1 << (idx & 7));
+    else if (! strchr(" ^E", maze [idx])) {
+      fprintf(stderr, "Square '%c' at row %lld, column %lld cannot be packed.\n",
+              maze [idx], idx / mazeparam -> cols, idx % mazeparam -> cols);
+      free(plane);
+      return (1);
+    }
+  }
+  if (   (fwrite(header, MAZEBIN_HEADER, 1, f) != 1)
+      || (fwrite(plane, planesize, 1, f) != 1)) {
+    perror("Cannot write binary maze");
+    free(plane);
+    return (1);
+  }
+  free(plane);
+  return (0);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      unpackmaze
+*
+* DESCRIPTION   Binary maze loader
+*
+* ARGUMENTS     data        The contents of a binary maze file
+*               size        Size of the contents
+*               maze        The maze map [OUTPUT]
+*               rle         Run-length rows to load into, NULL for none
+*               mazeparam   The maze parameter struct
+*
+* GLOBALS       -
+*
+* RETURNS       Error code (0 == Success)
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*               2026 10 18   JPT   Run-length rows
+*
+* NOTES         The format is described with packmaze(). The header is
+*               checked, and each byte of the wall plane is expanded into
+*               eight squares by a table lookup. The start and the exits
+*               are then put in place.
+*
+*               With rle, the rows are expanded one at a time into a row
+*               buffer and appended to rle instead, and the maze map is
+*               set to NULL.
+*
+*               IMPORTANT: Allocates heap memory, unless an error is
+*               returned!
+*
+\**************************************************************************/
+
+int unpackmaze(const char *data, size_t size, char **maze, rlemaze_t *rle,
+               mazeparam_t *mazeparam)
+{
+  const unsigned char *header = (const unsigned char *) data;
+  const unsigned char *plane = header + MAZEBIN_HEADER;
+  unsigned long long  squares [256];
+  unsigned int        rows, cols, exits;
+  long long           mazesize;
+  char                *grid;
+  if (   (size < MAZEBIN_HEADER)
+      || (get_u32(header + 4) != MAZEBIN_VERSION)) {
+    fprintf(stderr, "Unsupported binary maze version.\n");
+    return (1);
+  }
+  rows  = get_u32(header + 8);
+  cols  = get_u32(header + 12);
+  exits = get_u32(header + 24);
+  mazesize = (long long) rows * cols;
+  if (   (rows == 0) || (cols == 0) || (rows > INT_MAX) || (cols > INT_MAX)
+      || (exits > MAX_EXITS)
+      || (size - MAZEBIN_HEADER < (size_t) ((mazesize + 7) / 8))) {
+    fprintf(stderr, "Corrupt binary maze header.\n");
+    return (1);
+  }
+  mazeparam -> rows = (int) rows;
+  mazeparam -> cols = (int) cols;
+  mazeparam -> startrow = (int) get_u32(header + 16);
+  mazeparam -> startcol = (int) get_u32(header + 20);
+  mazeparam -> exits = (int) exits;
+  for (int e = 0; e < mazeparam -> exits; e++) {
+    mazeparam -> exitrow [e] = (int) get_u32(header + 28 + 4 * e);
+    mazeparam -> exitcol [e] = (int) get_u32(header + 28 + 4 * (MAX_EXITS + e));
+    if (outside(mazeparam, mazeparam -> exitrow [e], mazeparam -> exitcol [e])) {
+      fprintf(stderr, "Corrupt binary maze header.\n");
+      return (1);
+    }
+  }
+  if (outside(mazeparam, mazeparam -> startrow, mazeparam -> startcol)) {
+    fprintf(stderr, "Corrupt binary maze header.\n");
+    return (1);
+  }
+  grid = (char *) malloc(rle ? (size_t) cols
+                              : (size_t) ((mazesize + 7) & ~7LL));
+  if (grid == NULL) {
+    fprintf(stderr, "Cannot allocate memory for maze.\n");
+    return (1);
+  }
+  if (rle) {
+    for (int r = 0; r < mazeparam -> rows; r++) {
+      for (int c = 0; c < mazeparam -> cols; c++) {
+        long long idx = LIN(r, c);
+        grid [c] = ((plane [idx >> 3] >> (idx & 7)) & 1) ? '#' : ' ';
+      }
+      if (r == mazeparam -> startrow) grid [mazeparam -> startcol] = '^';
+      for (int e = 0; e < mazeparam -> exits; e++) {
+        if (r == mazeparam -> exitrow [e]) grid [mazeparam -> exitcol [e]] = 'E';
+      }
+      if (rle_append_row(rle, grid, mazeparam -> cols)) {
+        free(grid);
+        free_rle(rle);
+        return (1);
+      }
+    }
+    free(grid);
+    grid = NULL;
+  }
+  else {
+    for (int b = 0; b < 256; b++) {
+      char eight [8];
+      for (int i = 0; i < 8; i++) eight [i] = ((b >> i) & 1) ? '#' : ' ';
+      memcpy(&squares [b], eight, 8);
+    }
+    for (long long i = 0; i < (mazesize + 7) / 8; i++) {
+      memcpy(grid + 8 * i, &squares [plane [i]], 8);
+    }
+    grid [LIN(mazeparam -> startrow, mazeparam -> startcol)] = '^';
+    for (int e = 0; e < mazeparam -> exits; e++) {
+      grid [LIN(mazeparam -> exitrow [e], mazeparam -> exitcol [e])] = 'E';
+    }
+  }
+  mazeparam -> startcategory = START_EDGE;
+  if (   (mazeparam -> startrow > 0)
+      && (mazeparam -> startrow < mazeparam -> rows - 1)
+      && (mazeparam -> startcol > 0)
+      && (mazeparam -> startcol < mazeparam -> cols - 1)) {
+    mazeparam -> startcategory = START_INSIDE;
+  }
+  mazeparam -> rle = rle;
+  *maze = grid;
+  return (0);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      mapmaze
+*
+* DESCRIPTION   Single pass maze loader
+*
+* ARGUMENTS     filename    The name of the text file containing a maze
+*               maze        The maze map [OUTPUT]
+*               rle         Run-length rows to load into, NULL for none
+*               mazeparam   The maze parameter struct
+*
+* GLOBALS       -
+*
+* RETURNS       Error code (0 == Success)
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*               2026 10 18   JPT   Binary mazes
+*               2026 10 18   JPT   Run-length rows
+*
+* NOTES         Does the work of measuremaze(), loadmaze() and endpoints()
+*               with the same rules, but maps the file into memory and
+*               reads it once. The row ends and the endpoints are found
+*               by the same scan of next_linemark().
+*
+*               Unlike endpoints(), refuses a maze with more than MAX_EXITS
+*               exits before storing them.
+*
+*               The grid is first allocated as large as the file, which
+*               bounds it, and shrunk when the row count is known.
+*
+*               A file starting with MAZEBIN_MAGIC is a binary maze and is
+*               loaded by unpackmaze() instead.
+*
+*               With rle, which must be empty, each row is appended to it
+*               as soon as it is scanned, no grid is allocated and the
+*               maze map is set to NULL. mazeparam -> rle is set to rle in
+*               either case. mazeparam -> cellmask is set to NULL, see
+*               cellmask_layer().
+*
+*               IMPORTANT: Allocates heap memory, unless an error is
+*               returned!
+*
+\**************************************************************************/
+
+int mapmaze(char *filename, char **maze, rlemaze_t *rle, mazeparam_t *mazeparam)
+{
+  int         fd;
+  struct stat st;
+  const char  *text, *end, *line, *p;
+  char        *grid;
+  int         rv = 0;
+  mazeparam -> cellmask = NULL;
+  fd = open(filename, O_RDONLY);
+  if ((fd == -1) || (fstat(fd, &st) == -1)) {
+    perror("Cannot open input file");
+    if (fd != -1) close(fd);
+    return (1);
+  }
+  if (st.st_size == 0) {
+    fprintf(stderr, "The first maze row was empty\n");
+    close(fd);
+    return (1);
+  }
+  text = (const char *) mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (text == MAP_FAILED) {
+    perror("Cannot map input file");
+    return (1);
+  }
+  (void) madvise((void *) text, st.st_size, MADV_SEQUENTIAL);
+  if ((st.st_size >= 4) && (memcmp(text, MAZEBIN_MAGIC, 4) == 0)) {
+    rv = unpackmaze(text, st.st_size, maze, rle, mazeparam);
+    munmap((void *) text, st.st_size);
+    return (rv);
+  }
+  end = text + st.st_size;
+  grid = rle ? NULL : (char *) malloc(st.st_size);
+  if ((rle == NULL) && (grid == NULL)) {
+    fprintf(stderr, "Cannot allocate memory for maze.\n");
+    munmap((void *) text, st.st_size);
+    return (1);
+  }
+  mazeparam -> rows = 0;
+  mazeparam -> cols = 0;
+  mazeparam -> exits = 0;
+  mazeparam -> startcategory = START_EDGE;
+  for (line = text; (line < end) && (rv == 0); line = p + 1) {
+    int len;
+    for (p = next_linemark(line, end); (p < end) && (*p != '\n');
+         p = next_linemark(p + 1, end)) {
+      int       row = mazeparam -> rows;
+      long long col = p - line;
+      if (*p == '^') {
+        mazeparam -> startrow = row;
+        mazeparam -> startcol = col;
+        continue;
+      }
+      if (mazeparam -> exits == MAX_EXITS) {
+        fprintf(stderr, "Maximum number of exits (%d) exceeded.\n", MAX_EXITS);
+        rv = 1;
+        break;
+      }
+      mazeparam -> exitrow [mazeparam -> exits] = row;
+      mazeparam -> exitcol [mazeparam -> exits] = col;
+      (mazeparam -> exits) ++;
+    }
+    if (rv) break;
+    if (p - line > INT_MAX) {
+      fprintf (stderr, "Maze too wide, maximum allowed width is %d\n", INT_MAX);
+      rv = 1;
+      break;
+    }
+    for (len = (int) (p - line); (len > 0) && ! isgraph(line [len - 1]); len--);
+    if (mazeparam -> rows == 0) {
+      mazeparam -> cols = len;
+      if (len == 0) {
+        fprintf(stderr, "The first maze row was empty\n");
+        rv = 1;
+      }
+    }
+    else if (len == 0) break;
+    else if (len != mazeparam -> cols) {
+      fprintf(stderr, "Uneven row lengths in maze\n");
+      rv = 1;
+    }
+    if (rv || (rle && (rv = rle_append_row(rle, line, mazeparam -> cols)))) break;
+    if (grid) {
+      memcpy(grid + (size_t) mazeparam -> rows * mazeparam -> cols, line,
+             mazeparam -> cols);
+    }
+    mazeparam -> rows ++;
+  }
+  munmap((void *) text, st.st_size);
+  if (rv) {
+    free(grid);
+    if (rle) free_rle(rle);
+    return (1);
+  }
+  if (   (mazeparam -> startrow > 0)
+      && (mazeparam -> startrow < mazeparam -> rows - 1)
+      && (mazeparam -> startcol > 0)
+      && (mazeparam -> startcol < mazeparam -> cols - 1)) {
+    mazeparam -> startcategory = START_INSIDE;
+  }
+  mazeparam -> rle = rle;
+  *maze = NULL;
+  if (grid) {
+    *maze = (char *) realloc(grid, (size_t) mazeparam -> rows * mazeparam -> cols);
+    if (*maze == NULL) *maze = grid;
+  }
+  return (0);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      wall_sanity
+*
+* DESCRIPTION   Checks the sanity of the external walls
+*
+* ARGUMENTS     maze        The maze map [OUTPUT]
+*               mazeparam   The maze parameter struct
+*               abortflag   Flag to abort program at wall abnormality
+*
+* GLOBALS       -
+*
+* RETURNS       Sanity flag (0 == OK)
+*
+* HISTORY       2023 01 01   JPT   First implementation
+*               2026 10 18   JPT   64-bit indices
+*               2026 10 18   JPT   Squares by mazeval()
+*
+* NOTES         Offers a choice to correct errors. The corrections are
+*               written to the maze map, so run-length rows can only be
+*               checked with the abortflag set.
+*
+\**************************************************************************/
+
+int wall_sanity(char *maze, mazeparam_t *mazeparam, int abortflag)
+{
+  int flag = 0;
+  int rows = mazeparam -> rows;
+  int cols = mazeparam -> cols;
+  for (int i = 0; i < cols; i++) {
+    char north = mazeval(maze, mazeparam, 0, i);
+    char south = mazeval(maze, mazeparam, rows - 1, i);
+    flag = (int) ((north == ' ') || (south == ' '));
+    if (abortflag && (flag != 0)) return (1);
+    if (north == ' ') maze [LIN(0, i)] = '#';
+    if (south == ' ') maze [LIN(rows - 1, i)] = '#';
+  }
+  for (int i = 0; i < rows; i++) {
+    char west = mazeval(maze, mazeparam, i, 0);
+    char east = mazeval(maze, mazeparam, i, cols - 1);
+    flag = (int) ((west == ' ') || (east == ' '));
+    if (abortflag && (flag != 0)) return (1);
+    if (west == ' ') maze [LIN(i, 0)] = '#';
+    if (east == ' ') maze [LIN(i, cols - 1)] = '#';
+  }
+  /* The following are incorrectable */
+  if (   (mazeparam -> startrow == 0)
+      && (mazeval(maze, mazeparam, 1, mazeparam -> startcol) == '#')) {
+    return (1);
+  }
+  if (   (mazeparam -> startrow == rows - 1)
+      && (mazeval(maze, mazeparam, rows - 2, mazeparam -> startcol) == '#')) {
+    return (1);
+  }
+  if (   (mazeparam -> startcol == 0)
+      && (mazeval(maze, mazeparam, mazeparam -> startrow, 1) == '#')) {
+    return (1);
+  }
+  if (   (mazeparam -> startcol == cols - 1)
+      && (mazeval(maze, mazeparam, mazeparam -> startrow, cols - 2) == '#')) {
+    return (1);
+  }
+  return (0);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      printmaze
+*
+* DESCRIPTION   Maze result printer
+*
+* ARGUMENTS     maze        The maze map [INPUT]
+*               mazeparam   The maze parameter struct
+*               cleaned     Erasure of fruitless path branches
+*
+* GLOBALS       -
+*
+* RETURNS       Error code (0 == Success)
+*
+* HISTORY       2023 01 01   JPT   First implementation
+*               2026 10 18   JPT   Output to mazeparam -> out
+*               2026 10 18   JPT   Markers from mazeparam -> overlay
+*               2026 10 18   JPT   Row buffer from the heap
+*               2026 10 18   JPT   Rows by maze_row()
+*
+* NOTES         Expects a preloaded maze and valid mazeparams contents.
+*               The markers of the overlay layer, where set, are printed
+*               over the maze squares.
+*
+\**************************************************************************/
+
+int printmaze(const char *maze, mazeparam_t *mazeparam, int cleaned)
+{
+  char *s = (char *) malloc((size_t) mazeparam -> cols + 1);
+  if (s == NULL) {
+    fprintf(stderr, "Cannot allocate memory for printing.\n");
+    return (1);
+  }
+  for (int r = 0; r < mazeparam -> rows; r++) {
+    const char *m = maze_row(maze, mazeparam, r, s);
+    if (m != s) memcpy(s, m, mazeparam -> cols);
+    s [mazeparam -> cols] = '\0';
+    if (mazeparam -> overlay) {
+      const char *o = mazeparam -> overlay + LIN(r, 0);
+      for (int c = 0; c < mazeparam -> cols; c++) if (o [c]) s [c] = o [c];
+    }
+    if (r == mazeparam -> startrow) s [mazeparam -> startcol] = '^';
+    if (cleaned) {
+      for (int c = 0; c < mazeparam -> cols; c++) {
+        if (strchr("abc.", s [c])) s [c] = ' ';
+      }
+    }
+    fprintf(mazeparam -> out, "%s\n", s);
+  }
+  free(s);
+  return (0);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      init_overlay
+*
+* DESCRIPTION   Allocates an empty marker layer for a solver run
+*
+* ARGUMENTS     mazeparam   The maze parameter struct
+*
+* GLOBALS       -
+*
+* RETURNS       Error code (0 == Success)
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The solvers write their markers to mazeparam -> overlay
+*               and never to the maze, which several runs may share.
+*               Release with free_overlay().
+*
+\**************************************************************************/
+
+int init_overlay(mazeparam_t *mazeparam)
+{
+  mazeparam -> overlay =
+    (char *) calloc((size_t) mazeparam -> rows * mazeparam -> cols, 1);
+  if (mazeparam -> overlay == NULL) {
+    fprintf(stderr, "Cannot allocate memory for marker layer.\n");
+    return (1);
+  }
+  return (0);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      free_overlay
+*
+* DESCRIPTION   Releases the marker layer of a solver run
+*
+* ARGUMENTS     mazeparam   The maze parameter struct
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         -
+*
+\**************************************************************************/
+
+void free_overlay(mazeparam_t *mazeparam)
+{
+  free(mazeparam -> overlay);
+  mazeparam -> overlay = NULL;
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      mark_explored
+*
+* DESCRIPTION   Marks a square as explored
+*
+* ARGUMENTS     mazeparam   The maze parameter struct
+*               idx         Linear index of the square
+*               steps       Step count at the exploration
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*               2026 10 18   JPT   64-bit step count
+*
+* NOTES         'a' up to 20 steps, 'b' up to 150, 'c' up to 200, and '.'
+*               after that, as in the legend printed by solvemaze().
+*
+\**************************************************************************/
+
+void mark_explored(mazeparam_t *mazeparam, long long idx, long long steps)
+{
+  mazeparam -> overlay [idx] = '.';
+  if (steps < 200) mazeparam -> overlay [idx] = 'c';
+  if (steps < 150) mazeparam -> overlay [idx] = 'b';
+  if (steps <  20) mazeparam -> overlay [idx] = 'a';
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      mark_path
+*
+* DESCRIPTION   Marks a square as a part of the solution path
+*
+* ARGUMENTS     mazeparam   The maze parameter struct
+*               idx         Linear index of the square
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         An exploration marker turns into its uppercase form, and
+*               an unexplored square becomes 'O'.
+*
+\**************************************************************************/
+
+void mark_path(mazeparam_t *mazeparam, long long idx)
+{
+  char *o = &(mazeparam -> overlay [idx]);
+  if      (*o == 'a') *o = 'A';
+  else if (*o == 'b') *o = 'B';
+  else if (*o == 'c') *o = 'C';
+  else *o = 'O';
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      frontier_init
+*
+* DESCRIPTION   Allocates the chosen search frontier container
+*
+* ARGUMENTS     mazeparam   The maze parameter struct
+*               mazesize    Number of maze squares
+*
+* GLOBALS       -
+*
+* RETURNS       Error code (0 == Success)
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         mazeparam -> frontier selects the container:
+*
+*               FRONTIER_HEAP     Binary heap ordered by (distance, index)
+*               FRONTIER_BUCKET   Dial's bucket queue, constant time
+*                                 operations for unit step costs
+*               FRONTIER_LIST     The original ordered set, popping the
+*                                 smallest linear index regardless of
+*                                 the distance, with its nodes taken
+*                                 from a pool
+*
+\**************************************************************************/
+
+int frontier_init(mazeparam_t *mazeparam, int mazesize)
+{
+  mazeparam -> olist = NULL;
+  init_pool(&(mazeparam -> opool));
+  if (mazeparam -> frontier == FRONTIER_BUCKET) {
+    return (init_bucket(&(mazeparam -> obucket), mazesize, 1));
+  }
+  if (mazeparam -> frontier == FRONTIER_HEAP) {
+    return (init_heap(&(mazeparam -> oheap), mazesize));
+  }
+  return (0);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      frontier_free
+*
+* DESCRIPTION   Releases the search frontier container
+*
+* ARGUMENTS     mazeparam   The maze parameter struct
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The list nodes go back in bulk with their pool.
+*
+\**************************************************************************/
+
+void frontier_free(mazeparam_t *mazeparam)
+{
+  if (mazeparam -> frontier == FRONTIER_BUCKET) free_bucket(&(mazeparam -> obucket));
+  if (mazeparam -> frontier == FRONTIER_HEAP) free_heap(&(mazeparam -> oheap));
+  free_pool(&(mazeparam -> opool));
+  mazeparam -> olist = NULL;
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      frontier_size
+*
+* DESCRIPTION   Tells whether the search frontier has squares left
+*
+* ARGUMENTS     mazeparam   The maze parameter struct
+*
+* GLOBALS       -
+*
+* RETURNS       Number of squares in the frontier (nonzero for a
+*               non-empty list)
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         -
+*
+\**************************************************************************/
+
+int frontier_size(mazeparam_t *mazeparam)
+{
+  if (mazeparam -> frontier == FRONTIER_BUCKET) return (mazeparam -> obucket.size);
+  if (mazeparam -> frontier == FRONTIER_HEAP) return (mazeparam -> oheap.size);
+  return ((int) (mazeparam -> olist != NULL));
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      frontier_insert
+*
+* DESCRIPTION   Adds a square to the search frontier
+*
+* ARGUMENTS     mazeparam   The maze parameter struct
+*               idx         Linear index of the square
+*               dist        Distance of the square from the start
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         -
+*
+\**************************************************************************/
+
+void frontier_insert(mazeparam_t *mazeparam, int idx, int dist)
+{
+  if (mazeparam -> frontier == FRONTIER_BUCKET) {
+    insert_bucket(&(mazeparam -> obucket), idx, dist);
+  }
+  else if (mazeparam -> frontier == FRONTIER_HEAP) {
+    insert_heap(&(mazeparam -> oheap), idx, dist);
+  }
+  else insert_unique_pooled(&(mazeparam -> olist), idx, &(mazeparam -> opool));
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      frontier_decrease
+*
+* DESCRIPTION   Shortens the distance of a square already in the frontier
+*
+* ARGUMENTS     mazeparam   The maze parameter struct
+*               idx         Linear index of the square
+*               dist        New distance of the square from the start
+*
+* GLOBALS       -
+*
+* RETURNS       Flag for a shortened distance
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The list frontier carries no distances and never shortens.
+*
+\**************************************************************************/
+
+int frontier_decrease(mazeparam_t *mazeparam, int idx, int dist)
+{
+  if (mazeparam -> frontier == FRONTIER_BUCKET) {
+    if (dist >= key_bucket(&(mazeparam -> obucket), idx)) return (0);
+    insert_bucket(&(mazeparam -> obucket), idx, dist);
+    return (1);
+  }
+  if (mazeparam -> frontier == FRONTIER_HEAP) {
+    if (dist >= key_heap(&(mazeparam -> oheap), idx)) return (0);
+    decrease_heap(&(mazeparam -> oheap), idx, dist);
+    return (1);
+  }
+  return (0);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      frontier_pop
+*
+* DESCRIPTION   Removes the next square to expand from the frontier
+*
+* ARGUMENTS     mazeparam   The maze parameter struct
+*               dist        Distance of the square from the start [OUTPUT]
+*
+* GLOBALS       -
+*
+* RETURNS       Linear index of the square
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The frontier must not be empty. The list frontier reports
+*               distances of zero.
+*
+\**************************************************************************/
+
+int frontier_pop(mazeparam_t *mazeparam, int *dist)
+{
+  int idx;
+  if (mazeparam -> frontier == FRONTIER_BUCKET) {
+    idx = first_bucket(&(mazeparam -> obucket), dist);
+    delete_first_bucket(&(mazeparam -> obucket));
+    return (idx);
+  }
+  if (mazeparam -> frontier == FRONTIER_HEAP) {
+    long long key;
+    idx = first_heap(&(mazeparam -> oheap), &key);
+    delete_first_heap(&(mazeparam -> oheap));
+    *dist = (int) key;
+    return (idx);
+  }
+  idx = first_unique(mazeparam -> olist);
+  delete_first_unique_pooled(&(mazeparam -> olist), &(mazeparam -> opool));
+  *dist = 0;
+  return (idx);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      checkside
+*
+* DESCRIPTION   Blockage and parenthood of a potential next step
+*
+* ARGUMENTS     mazeparam   The maze parameter struct
+*               maze        The maze map [INPUT]
+*               exclusion   Squares already expanded
+*               parent_data Parallel map layer for parent headings
+*               siderow     Row of the potential next step
+*               sidecol     Column of the potential next step
+*               atrow       Current row
+*               atcol       Current column
+*               dist        Distance from start to the potential next step
+*
+* GLOBALS       -
+*
+* RETURNS       Access status (0 == Vacant)
+*
+* HISTORY       2023 01 01   JPT   First implementation
+*               2026 10 18   JPT   Distance keyed frontier
+*               2026 10 18   JPT   Unused atval dropped
+*               2026 10 18   JPT   Walls by walkable()
+*
+* NOTES         Used for different directions.
+*
+*               An exit is never a potential next step: a square next to
+*               an exit ends the search before its neighbours are checked.
+*
+*               A square already in the frontier is re-parented only if
+*               the new distance is shorter.
+*
+\**************************************************************************/
+
+void checkside (mazeparam_t *mazeparam, const char *maze, bitword_t *exclusion,
+                parent_data_t *parent_data,
+                int siderow, int sidecol, int atrow, int atcol, int dist)
+{
+  int row, col;
+  int idx = LIN(siderow, sidecol);
+  if (! walkable(maze, mazeparam, siderow, sidecol)) return;
+  if (BIT_TEST(exclusion, idx)) return;   /* Inside, walkable() said so */
+  get_parent_data (parent_data, mazeparam, siderow, sidecol, &row, &col);
+  if ((row == -1) || (col == -1)) {
+    frontier_insert(mazeparam, idx, dist);
+    set_parent_data(parent_data, mazeparam, siderow, sidecol, atrow, atcol);
+  }
+  else if (frontier_decrease(mazeparam, idx, dist)) {
+    set_parent_data(parent_data, mazeparam, siderow, sidecol, atrow, atcol);
+  }
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      init_observer
+*
+* DESCRIPTION   Sets up an observer of a solve
+*
+* ARGUMENTS     observer   The observer [OUTPUT]
+*               until      Steps below which visit is called
+*               visit      Called after each move, NULL for none
+*               finish     Called when the solve finishes, NULL for none
+*               data       Own data of the observer
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         -
+*
+\**************************************************************************/
+
+void init_observer(observer_t *observer, int until,
+                   void (* visit) (observer_t *, solve_t *),
+                   void (* finish) (observer_t *, solve_t *), void *data)
+{
+  observer -> until = (visit == NULL) ? 0 : until;
+  observer -> visit = visit;
+  observer -> finish = finish;
+  observer -> data = data;
+  observer -> next = NULL;
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      init_solve
+*
+* DESCRIPTION   Sets up a solve without observers
+*
+* ARGUMENTS     solve       The solve [OUTPUT]
+*               pentti      The current position and state
+*               maze        The maze map [INPUT]
+*               mazeparam   The maze parameter struct
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         A solve is a solving algorithm cut into an init function,
+*               which sets step and finish, any number of step calls of a
+*               given number of moves each, and a finish call. It can thus
+*               be run a time slice at a time. Attach the observers
+*               before the first step.
+*
+\**************************************************************************/
+
+void init_solve(solve_t *solve, pentti_t *pentti, const char *maze,
+                mazeparam_t *mazeparam)
+{
+  memset(solve, 0, sizeof (solve_t));
+  solve -> pentti = pentti;
+  solve -> maze = maze;
+  solve -> mazeparam = mazeparam;
+  solve -> status = -1;
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      attach_observer
+*
+* DESCRIPTION   Adds an observer to a solve
+*
+* ARGUMENTS     solve      The solve
+*               observer   The observer, owned by the caller
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The observers are called in the order of attaching. The
+*               solves call no observers past the largest until, which
+*               lets the wall walkers jump along the walls from there on.
+*
+\**************************************************************************/
+
+void attach_observer(solve_t *solve, observer_t *observer)
+{
+  observer_t **last = &(solve -> observers);
+  while (*last) last = &((*last) -> next);
+  *last = observer;
+  observer -> next = NULL;
+  if (observer -> until > solve -> until) solve -> until = observer -> until;
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      notify_observers
+*
+* DESCRIPTION   Calls the observers of a solve after a move
+*
+* ARGUMENTS     solve   The solve
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The solves call this only below solve -> until.
+*
+\**************************************************************************/
+
+void notify_observers(solve_t *solve)
+{
+  for (observer_t *o = solve -> observers; o; o = o -> next) {
+    if (solve -> pentti -> steps < o -> until) o -> visit(o, solve);
+  }
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      finish_observers
+*
+* DESCRIPTION   Tells the observers of a solve that it has finished
+*
+* ARGUMENTS     solve   The solve
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         -
+*
+\**************************************************************************/
+
+void finish_observers(solve_t *solve)
+{
+  for (observer_t *o = solve -> observers; o; o = o -> next) {
+    if (o -> finish) o -> finish(o, solve);
+  }
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      mark_trail
+*
+* DESCRIPTION   Observer marking the trail of a wall walker by step count
+*
+* ARGUMENTS     observer   The observer
+*               solve      The solve
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The walker itself marks its squares with 'O'. Attached
+*               with until 200 this makes 'A' up to 20 steps, 'B' up to
+*               150 and 'C' up to 200, as in the legend printed by
+*               solvemaze().
+*
+\**************************************************************************/
+
+void mark_trail(observer_t *observer, solve_t *solve)
+{
+  pentti_t *pentti = solve -> pentti;
+  char     *o = &(solve -> mazeparam -> overlay [pentti -> idx]);
+  (void) observer;
+  if (pentti -> steps < 200) *o = 'C';
+  if (pentti -> steps < 150) *o = 'B';
+  if (pentti -> steps <  20) *o = 'A';
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      mark_exploration
+*
+* DESCRIPTION   Observer marking the squares explored by a search
+*
+* ARGUMENTS     observer   The observer
+*               solve      The solve
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         See mark_explored(). Attach with until INT_MAX to have
+*               every explored square marked.
+*
+\**************************************************************************/
+
+void mark_exploration(observer_t *observer, solve_t *solve)
+{
+  (void) observer;
+  mark_explored(solve -> mazeparam, solve -> pentti -> idx, solve -> pentti -> steps);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      snapshot_due
+*
+* DESCRIPTION   Tells whether an intermediate state is printed at a step
+*
+* ARGUMENTS     steps   Step count of the solve
+*
+* GLOBALS       -
+*
+* RETURNS       1 at 20, 150 and 200 steps, 0 otherwise
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         -
+*
+\**************************************************************************/
+
+int snapshot_due(long long steps)
+{
+  return ((int) ((steps == 20) || (steps == 150) || (steps == 200)));
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      print_snapshot
+*
+* DESCRIPTION   Observer printing the intermediate states of a solve
+*
+* ARGUMENTS     observer   The observer
+*               solve      The solve
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*               2026 10 18   JPT   Steps by snapshot_due()
+*
+* NOTES         Prints the maze after the moves at 20, 150 and 200 steps.
+*               Attach with until 201, after the marking observer.
+*
+\**************************************************************************/
+
+void print_snapshot(observer_t *observer, solve_t *solve)
+{
+  long long steps = solve -> pentti -> steps;
+  (void) observer;
+  if (snapshot_due(steps)) {
+    fprintf(solve -> mazeparam -> out, "Intermediate state at %lldth step\n\n", steps);
+    printmaze(solve -> maze, solve -> mazeparam, 0);
+    fprintf(solve -> mazeparam -> out, "\n\n\n");
+  }
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      record_metrics
+*
+* DESCRIPTION   Observer recording the totals of a finished solve
+*
+* ARGUMENTS     observer   The observer, data pointing to a metrics_t
+*               solve      The solve
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         Attached as a finish callback only, it keeps no observer
+*               calls in the moves.
+*
+\**************************************************************************/
+
+void record_metrics(observer_t *observer, solve_t *solve)
+{
+  metrics_t *metrics = (metrics_t *) observer -> data;
+  metrics -> status = solve -> status;
+  metrics -> steps = solve -> pentti -> steps;
+  metrics -> moves = solve -> moves;
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      run_solve
+*
+* DESCRIPTION   Steps a solve to its end and finishes it
+*
+* ARGUMENTS     solve   The solve set up by an init function
+*               slice   Number of moves per step call
+*
+* GLOBALS       -
+*
+* RETURNS       Status from the finish function of the solve
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         -
+*
+\**************************************************************************/
+
+int run_solve(solve_t *solve, long long slice)
+{
+  while (solve -> done == 0) solve -> step(solve, slice);
+  return (solve -> finish(solve));
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      dijkstra_step
+*
+* DESCRIPTION   Steps Dijkstra's algorithm
+*
+* ARGUMENTS     solve   The solve set up by dijkstra_init()
+*               moves   Number of squares to explore at most
+*
+* GLOBALS       -
+*
+* RETURNS       1 when finished, 0 otherwise
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         A move explores the nearest square of the frontier. The
+*               neighbours are checked in the order north, east, south,
+*               west, which decides between paths of equal length.
+*
+\**************************************************************************/
+
+int dijkstra_step(solve_t *solve, long long moves)
+{
+  static const int sideorder [4] = {1, 0, 3, 2};   /* N, E, S, W */
+  pentti_t      *pentti = solve -> pentti;
+  const char    *maze = solve -> maze;
+  mazeparam_t   *mazeparam = solve -> mazeparam;
+  parent_data_t *parent_data = &(solve -> parent_layer);
+  int           idx, row, col, dist;
+  for (; moves > 0; moves --) {
+    if (frontier_size(mazeparam) == 0) {
+      solve -> done = 1;
+      break;
+    }
+    idx = frontier_pop(mazeparam, &dist);
+    ROWCOL (idx, row, col);
+    BIT_SET(solve -> exclusion, idx);
+    set_pentti_at(pentti, maze, mazeparam, row, col);
+    if (pentti -> steps < solve -> until) notify_observers(solve);
+    solve -> moves ++;
+    if (goalfound(pentti, maze, mazeparam)) {
+      int tracerow, tracecol;
+      solve -> found = 1;
+      solve -> done = 1;
+      tracerow = pentti -> row; tracecol = pentti -> col;
+      while (1) {
+        int idx, prow, pcol;
+	get_parent_data(parent_data, mazeparam, tracerow, tracecol, &prow, &pcol);
+        if ((tracerow == prow) && (tracecol == pcol)) break;
+        idx = LIN(tracerow, tracecol);
+        mark_path(mazeparam, idx);
+        tracerow = prow;
+        tracecol = pcol;
+      }
+      break;
+    }
+    for (int i = 0; i < 4; i++) {
+      int h = sideorder [i];
+      checkside(mazeparam, maze, solve -> exclusion, parent_data,
+                pentti -> row + headingrow [h], pentti -> col + headingcol [h],
+                pentti -> row, pentti -> col, dist + 1);
+    }
+  }
+  return (solve -> done);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      dijkstra_finish
+*
+* DESCRIPTION   Finishes Dijkstra's algorithm
+*
+* ARGUMENTS     solve   The solve set up by dijkstra_init()
+*
+* GLOBALS       -
+*
+* RETURNS       Error code (0 == Success)
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         Releases the layers of the search, also when the solve
+*               is abandoned before it is done.
+*
+\**************************************************************************/
+
+int dijkstra_finish(solve_t *solve)
+{
+  mazeparam_t *mazeparam = solve -> mazeparam;
+  long long   steps = solve -> pentti -> steps;
+  if (solve -> status == -1) {
+    frontier_free(mazeparam);
+    free_parent_data(&(solve -> parent_layer));
+    free(solve -> exclusion);
+    solve -> status = SOLVE_NOT_FOUND;
+    if (solve -> found == 0) {
+      fprintf(mazeparam -> out, "Exit not found after %lld steps\n\n", steps);
+    }
+    else {
+      fprintf(mazeparam -> out, "Final state at %lldth step\n\n", steps);
+      printmaze(solve -> maze, mazeparam, 0);
+      fprintf(mazeparam -> out, "\n\n\n");
+      solve -> status = SOLVE_OK;
+    }
+  }
+  finish_observers(solve);
+  return (solve -> status);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      dijkstra_init
+*
+* DESCRIPTION   Starts Dijkstra's algorithm
+*
+* ARGUMENTS     solve   The solve set up by init_solve()
+*
+* GLOBALS       -
+*
+* RETURNS       Error code (0 == Success)
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The frontier container is chosen by mazeparam -> frontier,
+*               see frontier_init(). On an error the solve is finished
+*               already.
+*
+\**************************************************************************/
+
+int dijkstra_init(solve_t *solve)
+{
+  mazeparam_t   *mazeparam = solve -> mazeparam;
+  parent_data_t *parent_data = &(solve -> parent_layer);
+  int           mazesize = mazeparam -> rows * mazeparam -> cols;
+  solve -> step = dijkstra_step;
+  solve -> finish = dijkstra_finish;
+  solve -> exclusion =
+    (bitword_t *) calloc(BITWORDS(mazesize), sizeof (bitword_t));
+  if (init_parent_data(parent_data, mazesize)) parent_data = NULL;
+  if (   (solve -> exclusion == NULL) || (parent_data == NULL)
+      || frontier_init(mazeparam, mazesize)) {
+    fprintf(stderr, "Cannot allocate memory for Dijkstra layers.\n");
+    if (parent_data) free_parent_data(parent_data);
+    free(solve -> exclusion);
+    solve -> status = 1;
+    solve -> done = 1;
+    return (1);
+  }
+  set_parent_data(parent_data, mazeparam,
+                  mazeparam -> startrow, mazeparam -> startcol,
+                  mazeparam -> startrow, mazeparam -> startcol);
+  frontier_insert(mazeparam, LIN(mazeparam -> startrow, mazeparam -> startcol), 0);
+  set_pentti_at(solve -> pentti, solve -> maze, mazeparam, 0, 0);
+  solve -> pentti -> steps = 0;
+  return (0);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      dijkstra
+*
+* DESCRIPTION   Dijkstra's maze traversing algorithm
+*
+* ARGUMENTS     pentti      The current position and state
+*               maze        The maze map [INPUT]
+*               mazeparam   The maze parameter struct
+*
+* GLOBALS       -
+*
+* RETURNS       Error code (0 == Success)
+*
+* HISTORY       2023 01 01   JPT   First implementation
+*               2026 10 18   JPT   Distance keyed frontier
+*               2026 10 18   JPT   Lean Pentti
+*               2026 10 18   JPT   Solve with observers
+*
+* NOTES         Runs dijkstra_init(), dijkstra_step() and dijkstra_finish()
+*               in one go, with the explored squares marked by
+*               mark_exploration() and the intermediate states printed by
+*               print_snapshot().
+*
+\**************************************************************************/
+
+int dijkstra(pentti_t *pentti, const char *maze, mazeparam_t *mazeparam)
+{
+  solve_t    solve;
+  observer_t marker, snapshots;
+  init_solve(&solve, pentti, maze, mazeparam);
+  init_observer(&marker, INT_MAX, mark_exploration, NULL, NULL);
+  init_observer(&snapshots, 201, print_snapshot, NULL, NULL);
+  attach_observer(&solve, &marker);
+  attach_observer(&solve, &snapshots);
+  dijkstra_init(&solve);
+  return (run_solve(&solve, LLONG_MAX));
+}
+
+
+
+/**************************************************************************\
+*
+* TABLE         wallturn
+*
+* DESCRIPTION   Wall follower transitions by open neighbour mask and heading
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         Indexed by the open neighbour bits of a wall mask layer
+*               square and the folded heading. -1 is a right turn and a
+*               step, 0 a step ahead and 1 a left turn without a step, as
+*               pledge() does with the right hand on the wall.
+*
+\**************************************************************************/
+
+static const signed char wallturn [16][4] = {
+  { 1,  1,  1,  1},   /* 0000 */
+  { 0, -1,  1,  1},   /* 0001 */
+  { 1,  0, -1,  1},   /* 0010 */
+  { 0, -1, -1,  1},   /* 0011 */
+  { 1,  1,  0, -1},   /* 0100 */
+  { 0, -1,  0, -1},   /* 0101 */
+  { 1,  0, -1, -1},   /* 0110 */
+  { 0, -1, -1, -1},   /* 0111 */
+  {-1,  1,  1,  0},   /* 1000 */
+  {-1, -1,  1,  0},   /* 1001 */
+  {-1,  0, -1,  0},   /* 1010 */
+  {-1, -1, -1,  0},   /* 1011 */
+  {-1,  1,  0, -1},   /* 1100 */
+  {-1, -1,  0, -1},   /* 1101 */
+  {-1,  0, -1, -1},   /* 1110 */
+  {-1, -1, -1, -1}    /* 1111 */
+};
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      restart_walkguard
+*
+* DESCRIPTION   Restarts the cycle detection of a walk from the present state
+*
+* ARGUMENTS     guard    The walk guard
+*               pentti   The current position and state
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         Needed whenever the moves change, e.g. when the trail
+*               marks a new wall which then reads as open. The move that
+*               marks it is still checked against the old state.
+*
+\**************************************************************************/
+
+void restart_walkguard(walkguard_t *guard, pentti_t *pentti)
+{
+  guard -> idx = pentti -> idx;
+  guard -> heading = pentti -> unfolded_heading;
+  guard -> crossed = (int) (pentti -> unfolded_heading == 0);
+  guard -> power = 1;
+  guard -> length = 0;
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      init_walkguard
+*
+* DESCRIPTION   Starts guarding a walk against cycles and its budget
+*
+* ARGUMENTS     guard    The walk guard [OUTPUT]
+*               pentti   The starting position and state
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         -
+*
+\**************************************************************************/
+
+void init_walkguard(walkguard_t *guard, pentti_t *pentti)
+{
+  guard -> moves = 0;
+  clock_gettime(CLOCK_MONOTONIC, &(guard -> start));
+  restart_walkguard(guard, pentti);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      check_walkguard
+*
+* DESCRIPTION   Brent's cycle detection and time budget check after a move
+*
+* ARGUMENTS     guard       The walk guard
+*               pentti      The current position and state
+*               mazeparam   The maze parameter struct
+*
+* GLOBALS       -
+*
+* RETURNS       WALK_ON, WALK_CYCLE or WALK_OVER_BUDGET
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*               2026 10 18   JPT   Step budget left to the walkers
+*
+* NOTES         The state is the square and the unfolded heading. It is
+*               compared with a saved state, which is moved to the present
+*               one after 1, 2, 4, ... moves, so a cycle is found within
+*               a few rounds of it in constant memory.
+*
+*               The unfolded heading of a Pledge walker circling an
+*               island, or the inside of a closed room, grows without
+*               bound and never repeats. The moves away from a zero
+*               heading do not depend on it, though, so returning to the
+*               same square and folded heading further from zero, without
+*               passing zero on the way, repeats forever too. The plain
+*               wall follower needs only the folded heading.
+*
+*               The clock is read every 65536 moves. The step budget is
+*               checked by the walkers before a move, see walk_step().
+*
+\**************************************************************************/
+
+int check_walkguard(walkguard_t *guard, pentti_t *pentti, mazeparam_t *mazeparam)
+{
+  int u = pentti -> unfolded_heading;
+  int saved = guard -> heading;
+  guard -> moves ++;
+  guard -> length ++;
+  if (u == 0) guard -> crossed = 1;
+  if ((pentti -> idx == guard -> idx) && ((u & 0x3) == (saved & 0x3))) {
+    if (   (mazeparam -> pledge_enable == 0) || (u == saved)
+        || ((guard -> crossed == 0) && ((saved > 0) ? (u > saved) : (u < saved)))) {
+      return (WALK_CYCLE);
+    }
+  }
+  if (guard -> length == guard -> power) {
+    guard -> idx = pentti -> idx;
+    guard -> heading = u;
+    guard -> crossed = (int) (u == 0);
+    guard -> power *= 2;
+    guard -> length = 0;
+  }
+  if ((mazeparam -> budget.seconds > 0) && ((guard -> moves & 0xffff) == 0)) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (  (double) (now.tv_sec - guard -> start.tv_sec)
+        + 1e-9 * (double) (now.tv_nsec - guard -> start.tv_nsec)
+        > mazeparam -> budget.seconds) return (WALK_OVER_BUDGET);
+  }
+  return (WALK_ON);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      trail_marked
+*
+* DESCRIPTION   Tells whether the trail has marked a square
+*
+* ARGUMENTS     mazeparam   The maze parameter struct
+*               row         Inquired row
+*               col         Inquired column
+*               idx         Linear index of the square
+*
+* GLOBALS       -
+*
+* RETURNS       1 for a marked square inside the maze, 0 otherwise
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The test pentti_open() makes for a square the wall mask
+*               layer reports closed.
+*
+\**************************************************************************/
+
+int trail_marked(mazeparam_t *mazeparam, int row, int col, long long idx)
+{
+  return ((int) (   (outside(mazeparam, row, col) == 0)
+                 && (mazeparam -> overlay [idx] != 0)));
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      follow_walls
+*
+* DESCRIPTION   Table driven wall following with jumps along straight walls
+*
+* ARGUMENTS     solve   The solve of a wall walker
+*               moves   Number of moves allowed
+*
+* GLOBALS       -
+*
+* RETURNS       WALK_GOAL when the goal is found, WALK_ON when out of
+*               moves, otherwise the reason to give up from
+*               check_walkguard()
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*               2026 10 18   JPT   Walk guard
+*               2026 10 18   JPT   Resumable
+*               2026 10 18   JPT   Stretches cut at the step budget
+*
+* NOTES         Makes the same moves as walk_step(), marking the squares
+*               with 'O' and calling no observers, but takes the turns
+*               from wallturn and steps over a straight stretch of wall at
+*               once. A stretch ends at a square where the hand leaves the
+*               wall, the way ahead is closed or an exit is next to it,
+*               or where the step budget runs out.
+*
+*               Requires the wall mask layer. A Pledge step from an open
+*               side may take the trail into a wall, which then reads as
+*               open to pentti_open(). Once that has happened the closed
+*               side and ahead squares are also checked for the trail.
+*
+\**************************************************************************/
+
+int follow_walls(solve_t *solve, long long moves)
+{
+  pentti_t            *pentti = solve -> pentti;
+  const char          *maze = solve -> maze;
+  mazeparam_t         *mazeparam = solve -> mazeparam;
+  walkguard_t         *guard = &(solve -> guard);
+  const unsigned char *cellmask = mazeparam -> cellmask;
+  char                *overlay = mazeparam -> overlay;
+  long long           padoffset [4];
+  long long           p = PADLIN(pentti -> row, pentti -> col);
+  long long           limit = (mazeparam -> budget.steps > 0) ? mazeparam -> budget.steps
+                                                              : LLONG_MAX;
+  int                 walk;
+  for (int h = 0; h < 4; h++) {
+    padoffset [h] = (long long) headingrow [h] * (mazeparam -> cols + 2) + headingcol [h];
+  }
+  for (; moves > 0; moves --) {
+    unsigned char m = cellmask [p];
+    int           f = pentti -> folded_heading;
+    int           side = (f + 3) & 3;
+    int           open = m & 0x0f;
+    int           turn, row, col, run = 0;
+    long long     idx;
+    unsigned char care, need;
+    int           newwall = 0;
+    if (m & CELL_NEXTTO_EXIT) return (WALK_GOAL);
+    if (pentti -> steps >= limit) return (WALK_OVER_BUDGET);
+    if (solve -> trailwall) {
+      open |= pentti_open(pentti, maze, mazeparam, side) << side;
+      open |= pentti_open(pentti, maze, mazeparam, f) << f;
+    }
+    if ((mazeparam -> pledge_enable != 0) && (pentti -> unfolded_heading == 0)) {
+      turn = (open & ((1 << side) | (1 << f))) ? 0 : 1;
+    }
+    else turn = wallturn [open][f];
+    if (turn == 1) {
+      turn_pentti(pentti, 1);
+      overlay [pentti -> idx] = 'O';
+    }
+    else {
+      if (turn == -1) turn_pentti(pentti, -1);
+      f = pentti -> folded_heading;
+      side = (f + 3) & 3;
+      need = (unsigned char) (1 << f);
+      care = (unsigned char) (CELL_NEXTTO_EXIT | need);
+      if ((mazeparam -> pledge_enable == 0) || (pentti -> unfolded_heading != 0)) {
+        care |= (unsigned char) (1 << side);
+      }
+      step_pentti(pentti);
+      p += padoffset [f];
+      newwall = (int) (   ((cellmask [p] & CELL_WALKABLE) == 0)
+                       && (overlay [pentti -> idx] == 0));
+      if (newwall) solve -> trailwall = 1;
+      overlay [pentti -> idx] = 'O';
+      row = pentti -> row;
+      col = pentti -> col;
+      idx = pentti -> idx;
+      while (   ((cellmask [p] & care) == need) && (pentti -> steps + run < limit)
+             && ! (   solve -> trailwall && (care & (1 << side))
+                   && trail_marked(mazeparam, row + headingrow [side],
+                                   col + headingcol [side],
+                                   idx + pentti -> offset [side]))) {
+        row += headingrow [f];
+        col += headingcol [f];
+        idx += pentti -> offset [f];
+        overlay [idx] = 'O';
+        p += padoffset [f];
+        run ++;
+      }
+      pentti -> row = row;
+      pentti -> col = col;
+      pentti -> idx = idx;
+      pentti -> steps += run;
+    }
+    solve -> moves ++;
+    walk = check_walkguard(guard, pentti, mazeparam);
+    if (walk != WALK_ON) return (walk);
+    if (newwall) restart_walkguard(guard, pentti);
+  }
+  return (WALK_ON);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      walk_step
+*
+* DESCRIPTION   Steps Pledge's algorithm or the wall follower
+*
+* ARGUMENTS     solve   The solve set up by walk_init()
+*               moves   Number of moves to make at most
+*
+* GLOBALS       -
+*
+* RETURNS       1 when finished, 0 otherwise
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*               2026 10 18   JPT   Step budget checked before a move
+*
+* NOTES         A move is a turn, a step or both. The walker marks each
+*               square it moves to with 'O' and calls the observers below
+*               their until. Past that the walk is left to follow_walls()
+*               when there is a wall mask layer.
+*
+*               The walk is given up when the step budget is used up
+*               before the goal is found.
+*
+*               Heading is expressed as quarter-revolutions to the positive
+*               direction from east. This number may be reduced to its
+*               two lowest bits in order to confine it within [0 .. 3] where
+*               necessary.
+*
+\**************************************************************************/
+
+int walk_step(solve_t *solve, long long moves)
+{
+  pentti_t    *pentti = solve -> pentti;
+  const char  *maze = solve -> maze;
+  mazeparam_t *mazeparam = solve -> mazeparam;
+  int         pledge_mode, newwall;
+  for (; (solve -> walk == WALK_ON) && (moves > 0); moves --) {
+    if (goalfound(pentti, maze, mazeparam)) {
+      solve -> walk = WALK_GOAL;
+      break;
+    }
+    if (   (mazeparam -> budget.steps > 0)
+        && (pentti -> steps >= mazeparam -> budget.steps)) {
+      solve -> walk = WALK_OVER_BUDGET;
+      break;
+    }
+    if ((mazeparam -> cellmask != NULL) && (pentti -> steps >= solve -> until)) {
+      if (solve -> fast == 0) {   /* A jump is a single move from now on */
+        solve -> fast = 1;
+        restart_walkguard(&(solve -> guard), pentti);
+      }
+      solve -> walk = follow_walls(solve, moves);
+      break;
+    }
+    pledge_mode = (int) (   (mazeparam -> pledge_enable != 0)
+                         && (pentti -> unfolded_heading == 0));
+    if (pentti_open(pentti, maze, mazeparam, pentti -> folded_heading + 3)) {
+      if (pledge_mode == 0) turn_pentti(pentti, -1);
+      step_pentti(pentti);
+    }
+    else if (! pentti_open(pentti, maze, mazeparam, pentti -> folded_heading))
+      turn_pentti(pentti, 1);
+    else step_pentti(pentti);
+    newwall = (int) (   (mazeparam -> overlay [pentti -> idx] == 0)
+                     && ! walkable(maze, mazeparam, pentti -> row, pentti -> col));
+    if (newwall) solve -> trailwall = 1;
+    mazeparam -> overlay [pentti -> idx] = 'O';
+    if (pentti -> steps < solve -> until) notify_observers(solve);
+    solve -> moves ++;
+    solve -> walk = check_walkguard(&(solve -> guard), pentti, mazeparam);
+    if (newwall) restart_walkguard(&(solve -> guard), pentti);
+  }
+  solve -> done = (int) (solve -> walk != WALK_ON);
+  return (solve -> done);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      walk_finish
+*
+* DESCRIPTION   Finishes Pledge's algorithm or the wall follower
+*
+* ARGUMENTS     solve   The solve set up by walk_init()
+*
+* GLOBALS       -
+*
+* RETURNS       SOLVE_OK, SOLVE_REFUSED for a wall follower starting
+*               inside the maze or SOLVE_UNSOLVABLE
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         An unfinished walk is reported as unsolvable within the
+*               moves it was given.
+*
+\**************************************************************************/
+
+int walk_finish(solve_t *solve)
+{
+  mazeparam_t *mazeparam = solve -> mazeparam;
+  long long   steps = solve -> pentti -> steps;
+  if (solve -> status == -1) {
+    solve -> status = SOLVE_UNSOLVABLE;
+    if (solve -> walk == WALK_GOAL) {
+      fprintf(mazeparam -> out, "Final state at %lldth step\n\n", steps);
+      solve -> status = SOLVE_OK;
+    }
+    else if (solve -> walk == WALK_CYCLE) {
+      fprintf(mazeparam -> out, "Exit not reachable, the walk repeats itself "
+              "after %lld steps\n\n", steps);
+    }
+    else {
+      fprintf(mazeparam -> out, "Exit not found within the budget, gave up "
+              "after %lld steps\n\n", steps);
+    }
+  }
+  finish_observers(solve);
+  return (solve -> status);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      walk_init
+*
+* DESCRIPTION   Starts Pledge's algorithm or the wall follower
+*
+* ARGUMENTS     solve   The solve set up by init_solve()
+*
+* GLOBALS       -
+*
+* RETURNS       Error code (0 == Success)
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The classic wall follower is chosen by setting
+*               pledge_enable = 0. It is refused for a start inside the
+*               maze, and the solve is then finished already.
+*
+*               The walk is given up as unsolvable when check_walkguard()
+*               finds it repeating itself, which happens when the exit
+*               cannot be reached, or when it runs out of mazeparam ->
+*               budget.
+*
+\**************************************************************************/
+
+int walk_init(solve_t *solve)
+{
+  pentti_t    *pentti = solve -> pentti;
+  mazeparam_t *mazeparam = solve -> mazeparam;
+  solve -> step = walk_step;
+  solve -> finish = walk_finish;
+  solve -> walk = WALK_ON;
+  if (   (mazeparam -> pledge_enable == 0)
+      && (mazeparam -> startcategory == START_INSIDE)) {
+    fprintf(mazeparam -> out,
+            "Classic wall follower may not have a solution for\n"
+            "an internal starting point if the maze is not\n"
+            "simply connected. Try with pledge_enable = 1.\n\n");
+    solve -> status = SOLVE_REFUSED;
+    solve -> done = 1;
+    return (1);
+  }
+  pentti -> unfolded_heading = 0;   /* East is the preferred heading */
+  pentti -> steps = 0;
+  set_pentti_at(pentti, solve -> maze, mazeparam,
+                mazeparam -> startrow, mazeparam -> startcol);
+  init_walkguard(&(solve -> guard), pentti);
+  return (0);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      pledge
+*
+* DESCRIPTION   Pledge's maze traversing algorithm
+*
+* ARGUMENTS     pentti      The current position and state
+*               maze        The maze map [INPUT]
+*               mazeparam   The maze parameter struct
+*
+* GLOBALS       -
+*
+* RETURNS       SOLVE_OK, SOLVE_REFUSED for a wall follower starting
+*               inside the maze or SOLVE_UNSOLVABLE
+*
+* HISTORY       2023 01 01   JPT   First implementation
+*               2026 10 18   JPT   Lean Pentti
+*               2026 10 18   JPT   Wall mask layer
+*               2026 10 18   JPT   Jumps by follow_walls()
+*               2026 10 18   JPT   Cycle detection and budget
+*               2026 10 18   JPT   Solve with observers
+*
+* NOTES         This algorithm can be used as the classic wall-follower by
+*               setting pledge_enable = 0.
+*
+*               Runs walk_init(), walk_step() and walk_finish() in one go,
+*               with the trail marked by mark_trail() and the intermediate
+*               states printed by print_snapshot().
+*
+\**************************************************************************/
+
+int pledge(pentti_t *pentti, const char *maze, mazeparam_t *mazeparam)
+{
+  solve_t    solve;
+  observer_t marker, snapshots;
+  init_solve(&solve, pentti, maze, mazeparam);
+  init_observer(&marker, 200, mark_trail, NULL, NULL);
+  init_observer(&snapshots, 201, print_snapshot, NULL, NULL);
+  attach_observer(&solve, &marker);
+  attach_observer(&solve, &snapshots);
+  walk_init(&solve);
+  return (run_solve(&solve, LLONG_MAX));
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      bitboard_expand_row
+*
+* DESCRIPTION   Grows one row of a bitboard BFS frontier by one layer
+*
+* ARGUMENTS     cur       Current frontier row
+*               up        Current frontier row above
+*               down      Current frontier row below
+*               open      Walkable squares of the row
+*               visited   Visited squares of the row [INPUT/OUTPUT]
+*               next      Next frontier row [OUTPUT]
+*               words     Number of bitwords per row
+*
+* GLOBALS       -
+*
+* RETURNS       Flag for any new squares in the row
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         Bit i of word w is the column 64 * w + i. The rows must
+*               have a zero padding word on both sides, so that the
+*               carries between words can be read without bounds checks.
+*
+*               Uses AVX2 or SSE2 where the compiler targets them, with a
+*               scalar loop for the remaining words.
+*
+\**************************************************************************/
+
+int bitboard_expand_row(bitword_t *cur, bitword_t *up, bitword_t *down,
+                        bitword_t *open, bitword_t *visited, bitword_t *next,
+                        int words)
+{
+  bitword_t any = 0;
+  int w = 0;
+#if defined(__AVX2__)
+  __m256i acc = _mm256_setzero_si256();
+  for (; w + 4 <= words; w += 4) {
+    __m256i c = _mm256_loadu_si256((__m256i *) (cur + w));
+    __m256i l = _mm256_loadu_si256((__m256i *) (cur + w - 1));
+    __m256i r = _mm256_loadu_si256((__m256i *) (cur + w + 1));
+    __m256i v = _mm256_loadu_si256((__m256i *) (visited + w));
+    __m256i n = _mm256_or_si256(_mm256_slli_epi64(c, 1), _mm256_srli_epi64(l, 63));
+    n = _mm256_or_si256(n, _mm256_srli_epi64(c, 1));
+    n = _mm256_or_si256(n, _mm256_slli_epi64(r, 63));
+    n = _mm256_or_si256(n, _mm256_loadu_si256((__m256i *) (up + w)));
+    n = _mm256_or_si256(n, _mm256_loadu_si256((__m256i *) (down + w)));
+    n = _mm256_and_si256(n, _mm256_loadu_si256((__m256i *) (open + w)));
+    n = _mm256_andnot_si256(v, n);
+    _mm256_storeu_si256((__m256i *) (next + w), n);
+    _mm256_storeu_si256((__m256i *) (visited + w), _mm256_or_si256(v, n));
+    acc = _mm256_or_si256(acc, n);
+  }
+  any = (bitword_t) ! _mm256_testz_si256(acc, acc);
+#elif defined(__SSE2__)
+  __m128i acc = _mm_setzero_si128();
+  for (; w + 2 <= words; w += 2) {
+    __m128i c = _mm_loadu_si128((__m128i *) (cur + w));
+    __m128i l = _mm_loadu_si128((__m128i *) (cur + w - 1));
+    __m128i r = _mm_loadu_si128((__m128i *) (cur + w + 1));
+    __m128i v = _mm_loadu_si128((__m128i *) (visited + w));
+    __m128i n = _mm_or_si128(_mm_slli_epi64(c, 1), _mm_srli_epi64(l, 63));
+    n = _mm_or_si128(n, _mm_srli_epi64(c, 1));
+    n = _mm_or_si128(n, _mm_slli_epi64(r, 63));
+    n = _mm_or_si128(n, _mm_loadu_si128((__m128i *) (up + w)));
+    n = _mm_or_si128(n, _mm_loadu_si128((__m128i *) (down + w)));
+    n = _mm_and_si128(n, _mm_loadu_si128((__m128i *) (open + w)));
+    n = _mm_andnot_si128(v, n);
+    _mm_storeu_si128((__m128i *) (next + w), n);
+    _mm_storeu_si128((__m128i *) (visited + w), _mm_or_si128(v, n));
+    acc = _mm_or_si128(acc, n);
+  }
+  any = (bitword_t) (_mm_movemask_epi8(_mm_cmpeq_epi8(acc, _mm_setzero_si128()))
+                     != 0xffff);
+#endif
+  for (; w < words; w++) {
+    bitword_t n = (cur [w] << 1) | (cur [w - 1] >> 63)
+                | (cur [w] >> 1) | (cur [w + 1] << 63)
+                | up [w] | down [w];
+    n &= open [w] & ~visited [w];
+    next [w] = n;
+    visited [w] |= n;
+    any |= n;
+  }
+  return ((int) (any != 0));
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      bitboard
+*
+* DESCRIPTION   Bit-parallel breadth-first maze traversing algorithm
+*
+* ARGUMENTS     pentti      The current position and state
+*               maze        The maze map [INPUT]
+*               mazeparam   The maze parameter struct
+*
+* GLOBALS       -
+*
+* RETURNS       Error code (0 == Success)
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*               2026 10 18   JPT   Rows by maze_row()
+*               2026 10 18   JPT   Snapshots by an observer
+*
+* NOTES         For unit step costs. The walls, the squares next to an
+*               exit, the visited squares and the frontier are stored as
+*               row bitboards of 64 squares per word, and a whole BFS
+*               layer is grown at once with shifts, ands and ors, see
+*               bitboard_expand_row(). Only the rows next to a non-empty
+*               frontier row are processed, so long corridors stay cheap.
+*
+*               A step is a BFS layer: the squares are marked by their
+*               distance from the start, which is also recorded in a
+*               distance layer. The shortest path is traced back from the
+*               first square found next to an exit by stepping to any
+*               neighbour one step closer to the start.
+*
+\**************************************************************************/
+
+int bitboard(pentti_t *pentti, const char *maze, mazeparam_t *mazeparam)
+{
+  solve_t    solve;
+  observer_t snapshots;
+  int        words = BITWORDS(mazeparam -> cols);
+  int        stride = words + 2;
+  int        mazesize = mazeparam -> rows * mazeparam -> cols;
+  size_t     boardsize = (size_t) (mazeparam -> rows + 2) * stride;
+  bitword_t  *board = (bitword_t *) calloc(5 * boardsize, sizeof (bitword_t));
+  bitword_t  *open = board;
+  bitword_t  *goal = open + boardsize;
+  bitword_t  *visited = goal + boardsize;
+  bitword_t  *cur = visited + boardsize;
+  bitword_t  *next = cur + boardsize;
+  int        *distance = (int *) malloc(mazesize * sizeof (int));
+  int        *active = (int *) malloc(3 * mazeparam -> rows * sizeof (int));
+  int        *grown = active + mazeparam -> rows;
+  int        *stamp = grown + mazeparam -> rows;
+  int        nactive = 1;
+  int        layer = 0;
+  int        goalidx = -1;
+  char       *rowbuf = (char *) malloc(mazeparam -> cols);
+  if ((board == NULL) || (distance == NULL) || (active == NULL) || (rowbuf == NULL)) {
+    fprintf(stderr, "Cannot allocate memory for bitboard layers.\n");
+    free(board);
+    free(distance);
+    free(active);
+    free(rowbuf);
+    return (1);
+  }
+  memset(distance, (unsigned char) 0xff, mazesize * sizeof (int));   /* -1 */
+  for (int row = 0; row < mazeparam -> rows; row++) {
+    const char *m = maze_row(maze, mazeparam, row, rowbuf);
+    stamp [row] = -1;
+    for (int col = 0; col < mazeparam -> cols; col++) {
+      if ((m [col] == '#') || (m [col] == 'E')) continue;
+      BOARDROW(open, row) [col >> 6] |= 1ULL << (col & 63);
+    }
+  }
+  free(rowbuf);
+  for (int e = 0; e < mazeparam -> exits; e++) {
+    for (int h = 0; h < 4; h++) {
+      int row = mazeparam -> exitrow [e] + headingrow [h];
+      int col = mazeparam -> exitcol [e] + headingcol [h];
+      if (outside(mazeparam, row, col)) continue;
+      BOARDROW(goal, row) [col >> 6] |=
+        BOARDROW(open, row) [col >> 6] & (1ULL << (col & 63));
+    }
+  }
+  BOARDROW(cur, mazeparam -> startrow) [mazeparam -> startcol >> 6] |=
+    1ULL << (mazeparam -> startcol & 63);
+  BOARDROW(visited, mazeparam -> startrow) [mazeparam -> startcol >> 6] |=
+    1ULL << (mazeparam -> startcol & 63);
+  distance [LIN(mazeparam -> startrow, mazeparam -> startcol)] = 0;
+  mark_explored(mazeparam, LIN(mazeparam -> startrow, mazeparam -> startcol), 0);
+  active [0] = mazeparam -> startrow;
+  init_solve(&solve, pentti, maze, mazeparam);
+  init_observer(&snapshots, 201, print_snapshot, NULL, NULL);
+  attach_observer(&solve, &snapshots);
+  pentti -> steps = 0;
+  while (nactive) {
+    int ngrown = 0;
+    for (int i = 0; (i < nactive) && (goalidx == -1); i++) {
+      bitword_t *c = BOARDROW(cur, active [i]);
+      bitword_t *g = BOARDROW(goal, active [i]);
+      for (int w = 0; w < words; w++) {
+        if (c [w] & g [w]) {
+          goalidx = LIN(active [i], 64 * w + __builtin_ctzll(c [w] & g [w]));
+          break;
+        }
+      }
+    }
+    if (goalidx != -1) break;
+    for (int i = 0; i < nactive; i++) {
+      for (int row = active [i] - 1; row <= active [i] + 1; row++) {
+        if ((row < 0) || (row >= mazeparam -> rows) || (stamp [row] == layer)) {
+          continue;
+        }
+        stamp [row] = layer;
+        if (! bitboard_expand_row(BOARDROW(cur, row), BOARDROW(cur, row - 1),
+                                  BOARDROW(cur, row + 1), BOARDROW(open, row),
+                                  BOARDROW(visited, row), BOARDROW(next, row),
+                                  words)) {
+          continue;
+        }
+        grown [ngrown ++] = row;
+        for (int w = 0; w < words; w++) {
+          for (bitword_t n = BOARDROW(next, row) [w]; n; n &= n - 1) {
+            int idx = LIN(row, 64 * w + __builtin_ctzll(n));
+            distance [idx] = layer + 1;
+            mark_explored(mazeparam, idx, layer + 1);
+          }
+        }
+      }
+    }
+    for (int i = 0; i < nactive; i++) {
+      memset(BOARDROW(cur, active [i]), 0, words * sizeof (bitword_t));
+    }
+    for (int i = 0; i < ngrown; i++) {   /* Other rows of next are zero */
+      active [i] = grown [i];
+    }
+    nactive = ngrown;
+    bitword_t *swap = cur; cur = next; next = swap;
+    layer ++;
+    pentti -> steps = layer;
+    if (pentti -> steps < solve.until) notify_observers(&solve);
+  }
+  if (goalidx != -1) {
+    int row, col;
+    ROWCOL(goalidx, row, col);
+    set_pentti_at(pentti, maze, mazeparam, row, col);
+    pentti -> steps = layer;
+    while (distance [LIN(row, col)] > 0) {
+      int idx = LIN(row, col);
+      int h;
+      mark_path(mazeparam, idx);
+      for (h = 0; h < 4; h++) {
+        int prow = row + headingrow [h];
+        int pcol = col + headingcol [h];
+        if (   (! outside(mazeparam, prow, pcol))
+            && (distance [LIN(prow, pcol)] == distance [idx] - 1)) break;
+      }
+      row += headingrow [h];
+      col += headingcol [h];
+    }
+  }
+  free(board);
+  free(distance);
+  free(active);
+  if (goalidx == -1) {
+    fprintf(mazeparam -> out, "Exit not found after %lld steps\n\n", pentti -> steps);
+    return (SOLVE_NOT_FOUND);
+  }
+  fprintf(mazeparam -> out, "Final state at %lldth step\n\n", pentti -> steps);
+  printmaze(maze, mazeparam, 0);
+  fprintf(mazeparam -> out, "\n\n\n");
+  return (0);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      bidirectional
+*
+* DESCRIPTION   Bidirectional breadth-first maze traversing algorithm
+*
+* ARGUMENTS     pentti      The current position and state
+*               maze        The maze map [INPUT]
+*               mazeparam   The maze parameter struct
+*
+* GLOBALS       -
+*
+* RETURNS       Error code (0 == Success)
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*               2026 10 18   JPT   Neighbours by open_mask()
+*               2026 10 18   JPT   Start next to an exit
+*               2026 10 18   JPT   Snapshots by an observer
+*
+* NOTES         One frontier grows from the start and another one from
+*               all the squares next to the exits recorded by endpoints().
+*               The smaller frontier is grown by a full layer at a time.
+*               When a layer touches the other side, the layer is
+*               finished and the shortest connection found is the
+*               shortest path.
+*
+*               The squares of both searches are marked in the order of
+*               expansion, as in dijkstra(). The distance layer holds the
+*               distance from the own source of each square, and a bit
+*               layer tells the sides apart. Both queues share a single
+*               array, the start side filling it from the front and the
+*               exit side from the back, as no square is queued twice.
+*
+\**************************************************************************/
+
+int bidirectional(pentti_t *pentti, const char *maze, mazeparam_t *mazeparam)
+{
+  solve_t    solve;
+  observer_t snapshots;
+  int        mazesize = mazeparam -> rows * mazeparam -> cols;
+  int        *distance = (int *) malloc(mazesize * sizeof (int));
+  int        *queue = (int *) malloc(mazesize * sizeof (int));
+  bitword_t  *fromexit =
+    (bitword_t *) calloc(BITWORDS(mazesize), sizeof (bitword_t));
+  int        head [2], tail [2];   /* Side 0 counts up, side 1 down */
+  int        start = LIN(mazeparam -> startrow, mazeparam -> startcol);
+  int        best = INT_MAX;
+  int        meet [2] = {-1, -1};  /* Adjacent squares of the two sides */
+  if ((distance == NULL) || (queue == NULL) || (fromexit == NULL)) {
+    fprintf(stderr, "Cannot allocate memory for bidirectional layers.\n");
+    free(distance);
+    free(queue);
+    free(fromexit);
+    return (1);
+  }
+  memset(distance, (unsigned char) 0xff, mazesize * sizeof (int));   /* -1 */
+  head [0] = tail [0] = 0;
+  head [1] = tail [1] = mazesize - 1;
+  distance [start] = 0;
+  queue [tail [0] ++] = start;
+  for (int e = 0; e < mazeparam -> exits; e++) {
+    for (int h = 0; h < 4; h++) {
+      int row = mazeparam -> exitrow [e] + headingrow [h];
+      int col = mazeparam -> exitcol [e] + headingcol [h];
+      if (! walkable(maze, mazeparam, row, col)) continue;
+      if (LIN(row, col) == start) best = 0;
+      if (distance [LIN(row, col)] != -1) continue;
+      distance [LIN(row, col)] = 0;
+      BIT_SET(fromexit, LIN(row, col));
+      queue [tail [1] --] = LIN(row, col);
+    }
+  }
+  if (best == 0) meet [0] = meet [1] = start;
+  init_solve(&solve, pentti, maze, mazeparam);
+  init_observer(&snapshots, 201, print_snapshot, NULL, NULL);
+  attach_observer(&solve, &snapshots);
+  pentti -> steps = 0;
+  while ((best == INT_MAX) && (tail [0] > head [0]) && (head [1] > tail [1])) {
+    int side = (int) (head [1] - tail [1] < tail [0] - head [0]);
+    int step = side ? -1 : 1;
+    int layer = side ? head [1] - tail [1] : tail [0] - head [0];
+    for (int k = 0; k < layer; k++) {
+      int idx = queue [head [side]];
+      int row, col, open;
+      head [side] += step;
+      ROWCOL(idx, row, col);
+      pentti -> steps ++;
+      mark_explored(mazeparam, idx, pentti -> steps);
+      if (pentti -> steps < solve.until) notify_observers(&solve);
+      open = open_mask(maze, mazeparam, row, col);
+      for (int h = 0; h < 4; h++) {
+        int nrow = row + headingrow [h];
+        int ncol = col + headingcol [h];
+        int nidx = LIN(nrow, ncol);
+        if (! ((open >> h) & 1)) continue;
+        if (distance [nidx] == -1) {
+          distance [nidx] = distance [idx] + 1;
+          if (side) BIT_SET(fromexit, nidx);
+          queue [tail [side]] = nidx;
+          tail [side] += step;
+        }
+        else if (   (BIT_TEST(fromexit, nidx) != side)
+                 && (distance [idx] + 1 + distance [nidx] < best)) {
+          best = distance [idx] + 1 + distance [nidx];
+          meet [side] = idx;
+          meet [1 - side] = nidx;
+        }
+      }
+    }
+  }
+  if (best != INT_MAX) {
+    for (int side = 0; side < 2; side++) {   /* Both halves of the path */
+      int idx = meet [side];
+      while (1) {
+        int row, col, h;
+        if (idx == start) break;
+        mark_path(mazeparam, idx);
+        if (distance [idx] == 0) break;
+        ROWCOL(idx, row, col);
+        for (h = 0; h < 4; h++) {
+          int prow = row + headingrow [h];
+          int pcol = col + headingcol [h];
+          if (   (! outside(mazeparam, prow, pcol))
+              && (distance [LIN(prow, pcol)] == distance [idx] - 1)
+              && (BIT_TEST(fromexit, LIN(prow, pcol)) == side)) break;
+        }
+        idx = LIN(row + headingrow [h], col + headingcol [h]);
+      }
+    }
+  }
+  free(distance);
+  free(queue);
+  free(fromexit);
+  if (best == INT_MAX) {
+    fprintf(mazeparam -> out, "Exit not found after %lld steps\n\n", pentti -> steps);
+    return (SOLVE_NOT_FOUND);
+  }
+  fprintf(mazeparam -> out, "Final state at %lldth step\n\n", pentti -> steps);
+  printmaze(maze, mazeparam, 0);
+  fprintf(mazeparam -> out, "\n\n\n");
+  return (0);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      heuristic
+*
+* DESCRIPTION   Lower bound of the steps from a square to the goal
+*
+* ARGUMENTS     mazeparam   The maze parameter struct
+*               row         Row of the square
+*               col         Column of the square
+*
+* GLOBALS       -
+*
+* RETURNS       Admissible estimate of the remaining steps
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The goal is any square next to an exit. By default the
+*               estimate is the smallest Manhattan distance to the exits
+*               recorded by endpoints(), minus the final step to the exit.
+*
+*               With mazeparam -> wall_heuristic set, only the premise of
+*               the goal lying on the external wall is used, and the
+*               estimate is the distance to the nearest wall square minus
+*               one. Both estimates change by at most one per step, so
+*               they are consistent, and A* expands every square once.
+*
+\**************************************************************************/
+
+int heuristic(mazeparam_t *mazeparam, int row, int col)
+{
+  int h = INT_MAX;
+  if (mazeparam -> wall_heuristic) {
+    h = row;
+    if (col < h) h = col;
+    if (mazeparam -> rows - 1 - row < h) h = mazeparam -> rows - 1 - row;
+    if (mazeparam -> cols - 1 - col < h) h = mazeparam -> cols - 1 - col;
+  }
+  else {
+    for (int e = 0; e < mazeparam -> exits; e++) {
+      int d = abs(row - mazeparam -> exitrow [e])
+            + abs(col - mazeparam -> exitcol [e]);
+      if (d < h) h = d;
+    }
+  }
+  return ((h > 0) ? h - 1 : 0);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      astar
+*
+* DESCRIPTION   A* maze traversing algorithm
+*
+* ARGUMENTS     pentti      The current position and state
+*               maze        The maze map [INPUT]
+*               mazeparam   The maze parameter struct
+*
+* GLOBALS       -
+*
+* RETURNS       Error code (0 == Success)
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*               2026 10 18   JPT   Neighbours by open_mask()
+*               2026 10 18   JPT   Snapshots by an observer
+*
+* NOTES         As dijkstra(), but the heap is ordered by the distance
+*               from the start g plus the heuristic() estimate h. Equal
+*               sums prefer the larger g, which heads straight for the
+*               goal across open rooms. The 64-bit heap key packs the sum
+*               into the upper half and the complement of g into the
+*               lower half.
+*
+*               The path length equals that of Dijkstra's algorithm, as
+*               the heuristic is admissible.
+*
+\**************************************************************************/
+
+int astar(pentti_t *pentti, const char *maze, mazeparam_t *mazeparam)
+{
+  solve_t       solve;
+  observer_t    snapshots;
+  int           found = 0;
+  int           mazesize = mazeparam -> rows * mazeparam -> cols;
+  int           start = LIN(mazeparam -> startrow, mazeparam -> startcol);
+  bitword_t     *exclusion =
+    (bitword_t *) calloc(BITWORDS(mazesize), sizeof (bitword_t));
+  parent_data_t parent_layer;
+  parent_data_t *parent_data = &parent_layer;
+  if (init_parent_data(parent_data, mazesize)) parent_data = NULL;
+  if (   (exclusion == NULL) || (parent_data == NULL)
+      || init_heap(&(mazeparam -> oheap), mazesize)) {
+    fprintf(stderr, "Cannot allocate memory for A* layers.\n");
+    if (parent_data) free_parent_data(parent_data);
+    free(exclusion);
+    return (1);
+  }
+#define ASTAR_KEY(g,h) ((((long long) (g) + (h)) << 32) | (0xffffffffLL - (g)))
+  set_parent_data(parent_data, mazeparam,
+                  mazeparam -> startrow, mazeparam -> startcol,
+                  mazeparam -> startrow, mazeparam -> startcol);
+  insert_heap(&(mazeparam -> oheap), start,
+              ASTAR_KEY(0, heuristic(mazeparam,
+                                     mazeparam -> startrow,
+                                     mazeparam -> startcol)));
+  init_solve(&solve, pentti, maze, mazeparam);
+  init_observer(&snapshots, 201, print_snapshot, NULL, NULL);
+  attach_observer(&solve, &snapshots);
+  pentti -> steps = 0;
+  while (mazeparam -> oheap.size) {
+    long long key;
+    int idx = first_heap(&(mazeparam -> oheap), &key);
+    int g = (int) (0xffffffffLL - (key & 0xffffffffLL));
+    int row, col, open;
+    delete_first_heap(&(mazeparam -> oheap));
+    ROWCOL(idx, row, col);
+    BIT_SET(exclusion, idx);
+    set_pentti_at(pentti, maze, mazeparam, row, col);
+    mark_explored(mazeparam, idx, pentti -> steps);
+    if (pentti -> steps < solve.until) notify_observers(&solve);
+    if (goalfound(pentti, maze, mazeparam)) {
+      found = 1;
+      while (idx != start) {
+        int prow, pcol;
+        mark_path(mazeparam, idx);
+        get_parent_data(parent_data, mazeparam, row, col, &prow, &pcol);
+        row = prow;
+        col = pcol;
+        idx = LIN(row, col);
+      }
+      break;
+    }
+    open = open_mask(maze, mazeparam, row, col);
+    for (int h = 0; h < 4; h++) {
+      int nrow = row + headingrow [h];
+      int ncol = col + headingcol [h];
+      int nidx = LIN(nrow, ncol);
+      int prow, pcol;
+      long long nkey;
+      if (! ((open >> h) & 1)) continue;
+      if (BIT_TEST(exclusion, nidx)) continue;
+      nkey = ASTAR_KEY(g + 1, heuristic(mazeparam, nrow, ncol));
+      get_parent_data(parent_data, mazeparam, nrow, ncol, &prow, &pcol);
+      if ((prow != -1) && (nkey >= key_heap(&(mazeparam -> oheap), nidx))) {
+        continue;
+      }
+      insert_heap(&(mazeparam -> oheap), nidx, nkey);
+      set_parent_data(parent_data, mazeparam, nrow, ncol, row, col);
+    }
+  }
+#undef ASTAR_KEY
+  free_heap(&(mazeparam -> oheap));
+  free_parent_data(parent_data);
+  free(exclusion);
+  if (found == 0) {
+    fprintf(mazeparam -> out, "Exit not found after %lld steps\n\n", pentti -> steps);
+    return (SOLVE_NOT_FOUND);
+  }
+  fprintf(mazeparam -> out, "Final state at %lldth step\n\n", pentti -> steps);
+  printmaze(maze, mazeparam, 0);
+  fprintf(mazeparam -> out, "\n\n\n");
+  return (0);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      jump
+*
+* DESCRIPTION   Runs straight from a square to the next jump point
+*
+* ARGUMENTS     maze        The maze map
+*               mazeparam   The maze parameter struct
+*               row         Row of the departure square
+*               col         Column of the departure square
+*               heading     Direction of the run (0 east ... 3 south)
+*
+* GLOBALS       -
+*
+* RETURNS       Linear index of the jump point, -1 if the run hits a wall
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The 4-connected rules of Jump Point Search. Of equally
+*               long paths only the ones turning vertical-first are kept.
+*               A horizontal run stops at a goal square and at a square
+*               with a forced neighbour: a free square above or below
+*               whose counterpart one step back is a wall. A vertical run
+*               stops at a goal square and at a square from which either
+*               horizontal run finds a jump point.
+*
+\**************************************************************************/
+
+int jump(const char *maze, mazeparam_t *mazeparam, int row, int col, int heading)
+{
+  int drow = headingrow [heading];
+  int dcol = headingcol [heading];
+  while (1) {
+    row += drow;
+    col += dcol;
+    if (! walkable(maze, mazeparam, row, col)) return (-1);
+    if (nextto_exit(maze, mazeparam, row, col)) return (LIN(row, col));
+    if (drow == 0) {
+      if (   (   walkable(maze, mazeparam, row - 1, col)
+              && ! walkable(maze, mazeparam, row - 1, col - dcol))
+          || (   walkable(maze, mazeparam, row + 1, col)
+              && ! walkable(maze, mazeparam, row + 1, col - dcol))) {
+        return (LIN(row, col));
+      }
+    }
+    else if (   (jump(maze, mazeparam, row, col, 0) != -1)
+             || (jump(maze, mazeparam, row, col, 2) != -1)) {
+      return (LIN(row, col));
+    }
+  }
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      jps
+*
+* DESCRIPTION   Jump Point Search maze traversing algorithm
+*
+* ARGUMENTS     pentti      The current position and state
+*               maze        The maze map [INPUT]
+*               mazeparam   The maze parameter struct
+*
+* GLOBALS       -
+*
+* RETURNS       Error code (0 == Success)
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*               2026 10 18   JPT   Snapshots by an observer
+*
+* NOTES         A* as in astar(), but only jump points found by jump()
+*               enter the heap. The successors of a jump point depend on
+*               its arrival heading: a horizontal arrival continues ahead
+*               and turns to forced neighbours only, a vertical arrival
+*               continues ahead and runs both ways horizontally, and the
+*               start runs in all four directions.
+*
+*               Only the expanded jump points get the exploration markers,
+*               and the pentti -> steps counter counts the expansions. The
+*               path is traced square by square along the straight runs
+*               between the jump points.
+*
+\**************************************************************************/
+
+int jps(pentti_t *pentti, const char *maze, mazeparam_t *mazeparam)
+{
+  solve_t       solve;
+  observer_t    snapshots;
+  int           found = 0;
+  int           jumppoints = 1;
+  int           mazesize = mazeparam -> rows * mazeparam -> cols;
+  int           start = LIN(mazeparam -> startrow, mazeparam -> startcol);
+  int           *from = (int *) malloc(mazesize * sizeof (int));
+  unsigned char *arrival = (unsigned char *) malloc(mazesize);
+  bitword_t     *exclusion =
+    (bitword_t *) calloc(BITWORDS(mazesize), sizeof (bitword_t));
+  if (   (from == NULL) || (arrival == NULL) || (exclusion == NULL)
+      || init_heap(&(mazeparam -> oheap), mazesize)) {
+    fprintf(stderr, "Cannot allocate memory for jump point layers.\n");
+    free(from);
+    free(arrival);
+    free(exclusion);
+    return (1);
+  }
+  memset(from, (unsigned char) 0xff, mazesize * sizeof (int));   /* -1 */
+#define JPS_KEY(g,h) ((((long long) (g) + (h)) << 32) | (0xffffffffLL - (g)))
+  from [start] = start;
+  arrival [start] = 4;
+  insert_heap(&(mazeparam -> oheap), start,
+              JPS_KEY(0, heuristic(mazeparam,
+                                   mazeparam -> startrow,
+                                   mazeparam -> startcol)));
+  init_solve(&solve, pentti, maze, mazeparam);
+  init_observer(&snapshots, 201, print_snapshot, NULL, NULL);
+  attach_observer(&solve, &snapshots);
+  pentti -> steps = 0;
+  while (mazeparam -> oheap.size) {
+    long long key;
+    int idx = first_heap(&(mazeparam -> oheap), &key);
+    int g = (int) (0xffffffffLL - (key & 0xffffffffLL));
+    int row, col;
+    int headings [4], nheadings = 0;
+    delete_first_heap(&(mazeparam -> oheap));
+    ROWCOL(idx, row, col);
+    BIT_SET(exclusion, idx);
+    set_pentti_at(pentti, maze, mazeparam, row, col);
+    mark_explored(mazeparam, idx, pentti -> steps);
+    if (pentti -> steps < solve.until) notify_observers(&solve);
+    if (goalfound(pentti, maze, mazeparam)) {
+      found = 1;
+      while (idx != start) {
+        int prev = from [idx];
+        int prow, pcol, step;
+        ROWCOL(prev, prow, pcol);
+        if (prow == row) step = (pcol < col) ? -1 : 1;
+        else step = (prow < row) ? -mazeparam -> cols : mazeparam -> cols;
+        for (; idx != prev; idx += step) {
+          mark_path(mazeparam, idx);
+        }
+        row = prow;
+        col = pcol;
+      }
+      break;
+    }
+    if (arrival [idx] == 4) {
+      for (int h = 0; h < 4; h++) headings [nheadings ++] = h;
+    }
+    else if ((arrival [idx] & 1) == 0) {   /* Horizontal arrival */
+      int dcol = headingcol [arrival [idx]];
+      headings [nheadings ++] = arrival [idx];
+      for (int h = 1; h < 4; h += 2) {
+        if (   walkable(maze, mazeparam, row + headingrow [h], col)
+            && ! walkable(maze, mazeparam, row + headingrow [h], col - dcol)) {
+          headings [nheadings ++] = h;
+        }
+      }
+    }
+    else {                                 /* Vertical arrival */
+      headings [nheadings ++] = arrival [idx];
+      headings [nheadings ++] = 0;
+      headings [nheadings ++] = 2;
+    }
+    for (int k = 0; k < nheadings; k++) {
+      int nidx = jump(maze, mazeparam, row, col, headings [k]);
+      int nrow, ncol;
+      long long nkey;
+      if ((nidx == -1) || BIT_TEST(exclusion, nidx)) continue;
+      ROWCOL(nidx, nrow, ncol);
+      nkey = JPS_KEY(g + abs(nrow - row) + abs(ncol - col),
+                     heuristic(mazeparam, nrow, ncol));
+      if (from [nidx] == -1) jumppoints++;
+      else if (nkey >= key_heap(&(mazeparam -> oheap), nidx)) continue;
+      insert_heap(&(mazeparam -> oheap), nidx, nkey);
+      from [nidx] = idx;
+      arrival [nidx] = (unsigned char) headings [k];
+    }
+  }
+#undef JPS_KEY
+  free_heap(&(mazeparam -> oheap));
+  free(from);
+  free(arrival);
+  free(exclusion);
+  fprintf(mazeparam -> out, "Jump points %d, expansions %lld\n\n", jumppoints, pentti -> steps);
+  if (found == 0) {
+    fprintf(mazeparam -> out, "Exit not found after %lld steps\n\n", pentti -> steps);
+    return (SOLVE_NOT_FOUND);
+  }
+  fprintf(mazeparam -> out, "Final state at %lldth step\n\n", pentti -> steps);
+  printmaze(maze, mazeparam, 0);
+  fprintf(mazeparam -> out, "\n\n\n");
+  return (0);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      corridor_next
+*
+* DESCRIPTION   Follows a corridor by one square
+*
+* ARGUMENTS     maze        The maze map
+*               mazeparam   The maze parameter struct
+*               idx         Linear index of the current corridor square
+*               prev        Linear index of the previous square
+*
+* GLOBALS       -
+*
+* RETURNS       Linear index of the next square, -1 if none
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         A corridor square has exactly two free neighbours, so the
+*               next square is the one not coming from.
+*
+\**************************************************************************/
+
+int corridor_next(const char *maze, mazeparam_t *mazeparam, int idx, int prev)
+{
+  int row, col;
+  ROWCOL(idx, row, col);
+  for (int h = 0; h < 4; h++) {
+    int nrow = row + headingrow [h];
+    int ncol = col + headingcol [h];
+    if (walkable(maze, mazeparam, nrow, ncol) && (LIN(nrow, ncol) != prev)) {
+      return (LIN(nrow, ncol));
+    }
+  }
+  return (-1);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      build_junction_graph
+*
+* DESCRIPTION   Collapses the corridors of a maze into weighted edges
+*
+* ARGUMENTS     graph       The graph to build [OUTPUT]
+*               maze        The maze map, as loaded by mazeinit()
+*               mazeparam   The maze parameter struct
+*
+* GLOBALS       -
+*
+* RETURNS       Error code (0 == Success)
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The nodes are the free squares not having exactly two free
+*               neighbours (junctions, dead ends and open rooms), the start
+*               square and the squares next to an exit. All the other free
+*               squares are corridor squares.
+*
+*               Every node has an edge slot per heading. The slot tells
+*               the node reached by leaving in that heading and following
+*               the corridor, and the length of the walk in steps. The
+*               walk itself is not stored, as corridor_next() repeats it.
+*
+\**************************************************************************/
+
+int build_junction_graph(junction_graph_t *graph, const char *maze,
+                         mazeparam_t *mazeparam)
+{
+  int mazesize = mazeparam -> rows * mazeparam -> cols;
+  int start = LIN(mazeparam -> startrow, mazeparam -> startcol);
+  graph -> nodes = 0;
+  graph -> edges = 0;
+  graph -> node = NULL;
+  graph -> to = NULL;
+  graph -> len = NULL;
+  graph -> nodeof = (int *) malloc(mazesize * sizeof (int));
+  if (graph -> nodeof == NULL) return (1);
+  for (int idx = 0; idx < mazesize; idx++) {
+    int row, col, degree = 0;
+    graph -> nodeof [idx] = -1;
+    ROWCOL(idx, row, col);
+    if (! walkable(maze, mazeparam, row, col)) continue;
+    for (int h = 0; h < 4; h++) {
+      degree += walkable(maze, mazeparam, row + headingrow [h], col + headingcol [h]);
+    }
+    if (   (degree != 2) || (idx == start)
+        || nextto_exit(maze, mazeparam, row, col)) {
+      graph -> nodeof [idx] = graph -> nodes ++;
+    }
+  }
+  graph -> node = (int *) malloc(graph -> nodes * sizeof (int));
+  graph -> to = (int *) malloc(4 * graph -> nodes * sizeof (int));
+  graph -> len = (int *) malloc(4 * graph -> nodes * sizeof (int));
+  if ((graph -> node == NULL) || (graph -> to == NULL) || (graph -> len == NULL)) {
+    return (1);
+  }
+  for (int idx = 0; idx < mazesize; idx++) {
+    if (graph -> nodeof [idx] != -1) graph -> node [graph -> nodeof [idx]] = idx;
+  }
+  for (int n = 0; n < graph -> nodes; n++) {
+    int row, col;
+    ROWCOL(graph -> node [n], row, col);
+    for (int h = 0; h < 4; h++) {
+      int prev = graph -> node [n];
+      int idx, length = 1;
+      graph -> to [4 * n + h] = -1;
+      graph -> len [4 * n + h] = 0;
+      if (! walkable(maze, mazeparam, row + headingrow [h], col + headingcol [h])) {
+        continue;
+      }
+      idx = LIN(row + headingrow [h], col + headingcol [h]);
+      while (graph -> nodeof [idx] == -1) {
+        int next = corridor_next(maze, mazeparam, idx, prev);
+        prev = idx;
+        idx = next;
+        length++;
+      }
+      graph -> to [4 * n + h] = graph -> nodeof [idx];
+      graph -> len [4 * n + h] = length;
+      graph -> edges ++;
+    }
+  }
+  return (0);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      free_junction_graph
+*
+* DESCRIPTION   Releases the layers of a junction graph
+*
+* ARGUMENTS     graph   The graph to release
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         Safe to call for a graph that was never built.
+*
+\**************************************************************************/
+
+void free_junction_graph(junction_graph_t *graph)
+{
+  free(graph -> node);
+  free(graph -> nodeof);
+  free(graph -> to);
+  free(graph -> len);
+  memset(graph, 0, sizeof (junction_graph_t));
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      junction_graph
+*
+* DESCRIPTION   Returns the junction graph of a maze, building it once
+*
+* ARGUMENTS     cache       The graph cache of the maze file
+*               maze        The maze map, as loaded by mazeinit()
+*               mazeparam   The maze parameter struct
+*
+* GLOBALS       -
+*
+* RETURNS       The graph, NULL if it cannot be built
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*               2026 10 18   JPT   Cache passed by the caller
+*
+* NOTES         The runs on the same maze file share the cache, see
+*               init_mazecache(). The first one builds the graph under
+*               the cache lock.
+*
+\**************************************************************************/
+
+junction_graph_t *junction_graph(mazecache_t *cache, const char *maze,
+                                 mazeparam_t *mazeparam)
+{
+  junction_graph_t *graph = &(cache -> junction);
+  pthread_mutex_lock(&(cache -> lock));
+  if (   (graph -> nodeof == NULL)
+      && build_junction_graph(graph, maze, mazeparam)) {
+    fprintf(stderr, "Cannot allocate memory for junction graph.\n");
+    free_junction_graph(graph);
+    graph = NULL;
+  }
+  pthread_mutex_unlock(&(cache -> lock));
+  return (graph);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      junction
+*
+* DESCRIPTION   Dijkstra's algorithm on the corridor-compressed graph
+*
+* ARGUMENTS     pentti      The current position and state
+*               maze        The maze map [INPUT]
+*               mazeparam   The maze parameter struct
+*
+* GLOBALS       -
+*
+* RETURNS       Error code (0 == Success)
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*               2026 10 18   JPT   Snapshots by an observer
+*
+* NOTES         Runs on mazeparam -> graph, attached by solvemaze(). Only
+*               the nodes of the graph enter the heap and get exploration
+*               markers, and the pentti -> steps counter counts the
+*               expanded nodes. The chosen edges are walked again square
+*               by square to mark the path.
+*
+\**************************************************************************/
+
+int junction(pentti_t *pentti, const char *maze, mazeparam_t *mazeparam)
+{
+  solve_t          solve;
+  observer_t       snapshots;
+  junction_graph_t *graph = mazeparam -> graph;
+  int              found = -1;
+  int              source;
+  int              *parent;
+  unsigned char    *via;      /* Heading of the edge from the parent */
+  if (graph == NULL) return (1);
+  source = graph -> nodeof [LIN(mazeparam -> startrow, mazeparam -> startcol)];
+  parent = (int *) malloc(graph -> nodes * sizeof (int));
+  via = (unsigned char *) calloc(graph -> nodes, 1);
+  if (   (parent == NULL) || (via == NULL)
+      || init_heap(&(mazeparam -> oheap), graph -> nodes)) {
+    fprintf(stderr, "Cannot allocate memory for junction search layers.\n");
+    free(parent);
+    free(via);
+    return (1);
+  }
+  fprintf(mazeparam -> out, "Junction graph has %d nodes and %d edges\n\n",
+          graph -> nodes, graph -> edges);
+  for (int n = 0; n < graph -> nodes; n++) parent [n] = -1;
+  parent [source] = source;
+  insert_heap(&(mazeparam -> oheap), source, 0);
+  init_solve(&solve, pentti, maze, mazeparam);
+  init_observer(&snapshots, 201, print_snapshot, NULL, NULL);
+  attach_observer(&solve, &snapshots);
+  pentti -> steps = 0;
+  while (mazeparam -> oheap.size) {
+    long long g;
+    int n = first_heap(&(mazeparam -> oheap), &g);
+    int idx = graph -> node [n];
+    int row, col;
+    delete_first_heap(&(mazeparam -> oheap));
+    via [n] |= 0x80;   /* Expanded */
+    ROWCOL(idx, row, col);
+    set_pentti_at(pentti, maze, mazeparam, row, col);
+    mark_explored(mazeparam, idx, pentti -> steps);
+    if (pentti -> steps < solve.until) notify_observers(&solve);
+    if (goalfound(pentti, maze, mazeparam)) {
+      found = n;
+      break;
+    }
+    for (int h = 0; h < 4; h++) {
+      int       m = graph -> to [4 * n + h];
+      long long mg = g + graph -> len [4 * n + h];
+      if ((m == -1) || (m == n)) continue;
+      if (parent [m] != -1) {
+        if ((via [m] & 0x80) || (mg >= key_heap(&(mazeparam -> oheap), m))) continue;
+      }
+      insert_heap(&(mazeparam -> oheap), m, mg);
+      parent [m] = n;
+      via [m] = (unsigned char) h;
+    }
+  }
+  for (int n = found; (n != -1) && (parent [n] != n); n = parent [n]) {
+    int p = parent [n];
+    int prev = graph -> node [p];
+    int idx, row, col;
+    ROWCOL(prev, row, col);
+    idx = LIN(row + headingrow [via [n] & 3], col + headingcol [via [n] & 3]);
+    while (1) {
+      int next;
+      mark_path(mazeparam, idx);
+      if (idx == graph -> node [n]) break;
+      next = corridor_next(maze, mazeparam, idx, prev);
+      prev = idx;
+      idx = next;
+    }
+  }
+  free_heap(&(mazeparam -> oheap));
+  free(parent);
+  free(via);
+  if (found == -1) {
+    fprintf(mazeparam -> out, "Exit not found after %lld steps\n\n", pentti -> steps);
+    return (SOLVE_NOT_FOUND);
+  }
+  fprintf(mazeparam -> out, "Final state at %lldth step\n\n", pentti -> steps);
+  printmaze(maze, mazeparam, 0);
+  fprintf(mazeparam -> out, "\n\n\n");
+  return (0);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      cpu_count
+*
+* DESCRIPTION   Number of worker threads to use
+*
+* ARGUMENTS     -
+*
+* GLOBALS       -
+*
+* RETURNS       Number of online processors, at least 1
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         -
+*
+\**************************************************************************/
+
+int cpu_count(void)
+{
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  return ((cpus > 0) ? (int) cpus : 1);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      hpa_cluster
+*
+* DESCRIPTION   Tells the HPA* cluster of a square
+*
+* ARGUMENTS     graph       The hierarchical graph
+*               mazeparam   The maze parameter struct
+*               idx         Linear index of the square
+*
+* GLOBALS       -
+*
+* RETURNS       Cluster number, clusters numbered row by row
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         -
+*
+\**************************************************************************/
+
+int hpa_cluster(hpa_graph_t *graph, mazeparam_t *mazeparam, int idx)
+{
+  int row, col;
+  ROWCOL(idx, row, col);
+  return ((row / graph -> size) * graph -> ccols + col / graph -> size);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      hpa_bfs
+*
+* DESCRIPTION   Breadth-first distances from a square within its cluster
+*
+* ARGUMENTS     graph       The hierarchical graph
+*               maze        The maze map
+*               mazeparam   The maze parameter struct
+*               source      Linear index of the source square
+*               dist        Distance of each cluster square, -1 if not
+*                           reached [OUTPUT]
+*               queue       Work area of size * size items
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The cluster squares are indexed locally as (row - top) *
+*               size + (col - left). The search never leaves the cluster.
+*
+\**************************************************************************/
+
+void hpa_bfs(hpa_graph_t *graph, const char *maze, mazeparam_t *mazeparam,
+             int source, int *dist, int *queue)
+{
+  int size = graph -> size;
+  int cluster = hpa_cluster(graph, mazeparam, source);
+  int top = (cluster / graph -> ccols) * size;
+  int left = (cluster % graph -> ccols) * size;
+  int bottom = (top + size < mazeparam -> rows) ? top + size : mazeparam -> rows;
+  int right = (left + size < mazeparam -> cols) ? left + size : mazeparam -> cols;
+  int head = 0, tail = 0;
+  int row, col;
+  for (int i = 0; i < size * size; i++) dist [i] = -1;
+  ROWCOL(source, row, col);
+  dist [(row - top) * size + (col - left)] = 0;
+  queue [tail ++] = (row - top) * size + (col - left);
+  while (head < tail) {
+    int local = queue [head ++];
+    row = top + local / size;
+    col = left + local % size;
+    for (int h = 0; h < 4; h++) {
+      int nrow = row + headingrow [h];
+      int ncol = col + headingcol [h];
+      int nlocal = (nrow - top) * size + (ncol - left);
+      if ((nrow < top) || (nrow >= bottom) || (ncol < left) || (ncol >= right)) {
+        continue;
+      }
+      if ((dist [nlocal] != -1) || ! walkable(maze, mazeparam, nrow, ncol)) continue;
+      dist [nlocal] = dist [local] + 1;
+      queue [tail ++] = nlocal;
+    }
+  }
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      hpa_node
+*
+* DESCRIPTION   Finds the entrance node of a square
+*
+* ARGUMENTS     graph       The hierarchical graph
+*               mazeparam   The maze parameter struct
+*               idx         Linear index of the square
+*
+* GLOBALS       -
+*
+* RETURNS       Node number, -1 if the square is not an entrance
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The nodes of a cluster are sorted by the linear index, so
+*               a binary search suffices.
+*
+\**************************************************************************/
+
+int hpa_node(hpa_graph_t *graph, mazeparam_t *mazeparam, int idx)
+{
+  int cluster = hpa_cluster(graph, mazeparam, idx);
+  int lo = graph -> first [cluster];
+  int hi = graph -> first [cluster + 1] - 1;
+  while (lo <= hi) {
+    int mid = (lo + hi) / 2;
+    if (graph -> node [mid] == idx) return (mid);
+    if (graph -> node [mid] < idx) lo = mid + 1;
+    else hi = mid - 1;
+  }
+  return (-1);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      hpa_worker
+*
+* DESCRIPTION   Computes the intra-cluster distances of a share of clusters
+*
+* ARGUMENTS     arg   Pointer to the hpa_work_t of the thread
+*
+* GLOBALS       -
+*
+* RETURNS       NULL
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         Thread t takes the clusters t, t + threads, t + 2 * threads
+*               and so on. Each cluster writes only its own distance
+*               matrix, so the threads need no locking.
+*
+\**************************************************************************/
+
+void *hpa_worker(void *arg)
+{
+  hpa_work_t  *work = (hpa_work_t *) arg;
+  hpa_graph_t *graph = work -> graph;
+  int         area = graph -> size * graph -> size;
+  int         *dist = (int *) malloc(area * sizeof (int));
+  int         *queue = (int *) malloc(area * sizeof (int));
+  mazeparam_t *mazeparam = work -> mazeparam;
+  if ((dist == NULL) || (queue == NULL)) {
+    work -> err = 1;
+    free(dist);
+    free(queue);
+    return (NULL);
+  }
+  for (int c = work -> thread; c < graph -> clusters; c += work -> threads) {
+    int first = graph -> first [c];
+    int k = graph -> first [c + 1] - first;
+    int top = (c / graph -> ccols) * graph -> size;
+    int left = (c % graph -> ccols) * graph -> size;
+    for (int i = 0; i < k; i++) {
+      hpa_bfs(graph, work -> maze, mazeparam, graph -> node [first + i], dist, queue);
+      for (int j = 0; j < k; j++) {
+        int row, col;
+        ROWCOL(graph -> node [first + j], row, col);
+        graph -> dist [graph -> offset [c] + (size_t) i * k + j] =
+          dist [(row - top) * graph -> size + (col - left)];
+      }
+    }
+  }
+  free(dist);
+  free(queue);
+  return (NULL);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      hpa_compare
+*
+* DESCRIPTION   qsort() comparison of two linear indices
+*
+* ARGUMENTS     a   Pointer to the first index
+*               b   Pointer to the second index
+*
+* GLOBALS       -
+*
+* RETURNS       Negative, zero or positive as in strcmp()
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         -
+*
+\**************************************************************************/
+
+int hpa_compare(const void *a, const void *b)
+{
+  return ((*(const int *) a > *(const int *) b) - (*(const int *) a < *(const int *) b));
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      build_hpa_graph
+*
+* DESCRIPTION   Builds the abstract graph of hierarchical A* (HPA*)
+*
+* ARGUMENTS     graph       The graph to build [OUTPUT]
+*               maze        The maze map, as loaded by mazeinit()
+*               mazeparam   The maze parameter struct
+*               size        Cluster side in squares
+*               threads     Number of threads for the distance tables
+*
+* GLOBALS       -
+*
+* RETURNS       Error code (0 == Success)
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The maze is split into size x size clusters. Along every
+*               border between two clusters each maximal run of free
+*               square pairs forms an entrance: a run shorter than
+*               HPA_LONG_ENTRANCE gets one square pair in its middle, a
+*               longer run one pair at both ends. The squares of the pairs
+*               are the nodes of the graph. A node is linked to its pair
+*               across the border by a single step, and to the other nodes
+*               of its cluster by the breadth-first distances within the
+*               cluster, computed by hpa_worker() threads.
+*
+*               The entrances keep the graph small, and therefore the
+*               abstract paths detour through them. hpa() smooths the
+*               refined path to take the detours out again.
+*
+\**************************************************************************/
+
+int build_hpa_graph(hpa_graph_t *graph, const char *maze, mazeparam_t *mazeparam,
+                    int size, int threads)
+{
+  int        *pairs = NULL;    /* Square pairs and headings, 3 per entrance */
+  int        npairs = 0, maxpairs = 0;
+  int        *count;
+  pthread_t  *tid;
+  hpa_work_t *work;
+  int        err = 0;
+  memset(graph, 0, sizeof (hpa_graph_t));
+  graph -> size = size;
+  graph -> crows = (mazeparam -> rows + size - 1) / size;
+  graph -> ccols = (mazeparam -> cols + size - 1) / size;
+  graph -> clusters = graph -> crows * graph -> ccols;
+  for (int h = 0; h < 4; h += 3) {   /* East and south borders */
+    int lines = (h == 0) ? mazeparam -> cols : mazeparam -> rows;
+    int along = (h == 0) ? mazeparam -> rows : mazeparam -> cols;
+    for (int line = size - 1; line + 1 < lines; line += size) {
+      for (int seg = 0; seg < along; seg += size) {   /* One cluster pair */
+        int segend = (seg + size < along) ? seg + size : along;
+        int run = 0;
+        for (int pos = seg; pos <= segend; pos++) {
+          int row = (h == 0) ? pos : line;
+          int col = (h == 0) ? line : pos;
+          int ends [2];
+          if (   (pos < segend) && walkable(maze, mazeparam, row, col)
+              && walkable(maze, mazeparam, row + headingrow [h], col + headingcol [h])) {
+            run++;
+            continue;
+          }
+          ends [0] = ends [1] = pos - run + run / 2;
+          if (run >= HPA_LONG_ENTRANCE) {
+            ends [0] = pos - run;
+            ends [1] = pos - 1;
+          }
+          for (int e = 0; (run > 0) && (e < 1 + (ends [1] != ends [0])); e++) {
+            int erow = (h == 0) ? ends [e] : line;
+            int ecol = (h == 0) ? line : ends [e];
+            if (npairs == maxpairs) {
+              int *grown;
+              maxpairs = maxpairs ? 2 * maxpairs : 1024;
+              grown = (int *) realloc(pairs, 3 * maxpairs * sizeof (int));
+              if (grown == NULL) {free(pairs); return (1);}
+              pairs = grown;
+            }
+            pairs [3 * npairs]     = LIN(erow, ecol);
+            pairs [3 * npairs + 1] = LIN(erow + headingrow [h], ecol + headingcol [h]);
+            pairs [3 * npairs + 2] = h;
+            npairs++;
+          }
+          run = 0;
+        }
+      }
+    }
+  }
+  graph -> first = (int *) calloc(graph -> clusters + 1, sizeof (int));
+  graph -> offset = (size_t *) malloc((graph -> clusters + 1) * sizeof (size_t));
+  graph -> node = (int *) malloc((2 * npairs + 1) * sizeof (int));
+  count = (int *) calloc(graph -> clusters + 1, sizeof (int));
+  if (   (graph -> first == NULL) || (graph -> offset == NULL)
+      || (graph -> node == NULL) || (count == NULL)) {
+    free(pairs);
+    free(count);
+    return (1);
+  }
+  for (int i = 0; i < 2 * npairs; i++) {   /* Counting sort by cluster */
+    count [hpa_cluster(graph, mazeparam, pairs [3 * (i / 2) + i % 2]) + 1]++;
+  }
+  for (int c = 0; c < graph -> clusters; c++) count [c + 1] += count [c];
+  for (int i = 0; i < 2 * npairs; i++) {
+    int idx = pairs [3 * (i / 2) + i % 2];
+    graph -> node [count [hpa_cluster(graph, mazeparam, idx)] ++] = idx;
+  }
+  for (int c = 0, from = 0; c < graph -> clusters; c++) {   /* Unique */
+    int to = count [c];
+    qsort(graph -> node + from, to - from, sizeof (int), hpa_compare);
+    graph -> first [c] = graph -> nodes;
+    for (int i = from; i < to; i++) {
+      if ((i == from) || (graph -> node [i] != graph -> node [i - 1])) {
+        graph -> node [graph -> nodes ++] = graph -> node [i];
+      }
+    }
+    from = to;
+  }
+  graph -> first [graph -> clusters] = graph -> nodes;
+  free(count);
+  graph -> offset [0] = 0;
+  for (int c = 0; c < graph -> clusters; c++) {
+    size_t k = graph -> first [c + 1] - graph -> first [c];
+    graph -> offset [c + 1] = graph -> offset [c] + k * k;
+  }
+  graph -> across = (int *) malloc((4 * graph -> nodes + 1) * sizeof (int));
+  graph -> dist = (int *) malloc((graph -> offset [graph -> clusters] + 1) * sizeof (int));
+  if ((graph -> across == NULL) || (graph -> dist == NULL)) {
+    free(pairs);
+    return (1);
+  }
+  for (int i = 0; i < 4 * graph -> nodes; i++) graph -> across [i] = -1;
+  for (int p = 0; p < npairs; p++) {
+    int a = hpa_node(graph, mazeparam, pairs [3 * p]);
+    int b = hpa_node(graph, mazeparam, pairs [3 * p + 1]);
+    int h = pairs [3 * p + 2];
+    graph -> across [4 * a + h] = b;
+    graph -> across [4 * b + ((h + 2) & 3)] = a;
+  }
+  free(pairs);
+  if (threads < 1) threads = 1;
+  tid = (pthread_t *) malloc(threads * sizeof (pthread_t));
+  work = (hpa_work_t *) calloc(threads, sizeof (hpa_work_t));
+  if ((tid == NULL) || (work == NULL)) {
+    free(tid);
+    free(work);
+    return (1);
+  }
+  for (int t = 0; t < threads; t++) {
+    work [t].graph = graph;
+    work [t].maze = maze;
+    work [t].mazeparam = mazeparam;
+    work [t].thread = t;
+    work [t].threads = threads;
+    if ((t > 0) && pthread_create(&tid [t], NULL, hpa_worker, &work [t])) {
+      work [t].threads = -1;   /* Not started, done below */
+    }
+  }
+  hpa_worker(&work [0]);
+  for (int t = 1; t < threads; t++) {
+    if (work [t].threads == -1) {
+      work [t].threads = threads;
+      hpa_worker(&work [t]);
+    }
+    else pthread_join(tid [t], NULL);
+  }
+  for (int t = 0; t < threads; t++) err |= work [t].err;
+  free(tid);
+  free(work);
+  return (err);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      free_hpa_graph
+*
+* DESCRIPTION   Releases the layers of an HPA* graph
+*
+* ARGUMENTS     graph   The graph to release
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         Safe to call for a graph that was never built.
+*
+\**************************************************************************/
+
+void free_hpa_graph(hpa_graph_t *graph)
+{
+  free(graph -> node);
+  free(graph -> first);
+  free(graph -> offset);
+  free(graph -> across);
+  free(graph -> dist);
+  memset(graph, 0, sizeof (hpa_graph_t));
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      hpa_graph
+*
+* DESCRIPTION   Returns the HPA* graph of a maze, building it once
+*
+* ARGUMENTS     cache       The graph cache of the maze file
+*               maze        The maze map, as loaded by mazeinit()
+*               mazeparam   The maze parameter struct
+*
+* GLOBALS       -
+*
+* RETURNS       The graph, NULL if it cannot be built
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*               2026 10 18   JPT   Cache passed by the caller
+*               2026 10 18   JPT   Threads from mazeparam -> threads
+*
+* NOTES         As junction_graph(). The distance tables are computed by
+*               mazeparam -> threads threads, by default one per online
+*               processor.
+*
+\**************************************************************************/
+
+hpa_graph_t *hpa_graph(mazecache_t *cache, const char *maze, mazeparam_t *mazeparam)
+{
+  hpa_graph_t *graph = &(cache -> hpa);
+  int         threads = mazeparam -> threads ? mazeparam -> threads : cpu_count();
+  pthread_mutex_lock(&(cache -> lock));
+  if (   (graph -> first == NULL)
+      && build_hpa_graph(graph, maze, mazeparam, HPA_CLUSTER_SIZE, threads)) {
+    fprintf(stderr, "Cannot allocate memory for HPA* graph.\n");
+    free_hpa_graph(graph);
+    graph = NULL;
+  }
+  pthread_mutex_unlock(&(cache -> lock));
+  return (graph);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      init_mazecache
+*
+* DESCRIPTION   Prepares an empty graph cache for a maze file
+*
+* ARGUMENTS     cache   The cache to prepare
+*               refs    Number of runs to share the cache
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The maze is loaded on demand by cached_maze(), and the
+*               graphs are built on demand by junction_graph() and
+*               hpa_graph(). Every run calls release_mazecache() when
+*               done, and the last one frees them.
+*
+\**************************************************************************/
+
+void init_mazecache(mazecache_t *cache, int refs)
+{
+  memset(cache, 0, sizeof (mazecache_t));
+  pthread_mutex_init(&(cache -> lock), NULL);
+  cache -> refs = refs;
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      release_mazecache
+*
+* DESCRIPTION   Ends the use of a graph cache by one run
+*
+* ARGUMENTS     cache   The cache to release
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The maze and the graphs are freed after the last run. The
+*               cache struct itself stays with its owner.
+*
+\**************************************************************************/
+
+void release_mazecache(mazecache_t *cache)
+{
+  int last;
+  pthread_mutex_lock(&(cache -> lock));
+  last = (-- cache -> refs == 0);
+  pthread_mutex_unlock(&(cache -> lock));
+  if (last) {
+    free(cache -> maze);
+    cache -> maze = NULL;
+    free_rle(&(cache -> runs));
+    free_junction_graph(&(cache -> junction));
+    free_hpa_graph(&(cache -> hpa));
+    pthread_mutex_destroy(&(cache -> lock));
+  }
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      hpa_smooth
+*
+* DESCRIPTION   Shortens a refined HPA* path window by window
+*
+* ARGUMENTS     maze        The maze map [INPUT]
+*               mazeparam   The maze parameter struct
+*               path        Squares of the path, each next to the one
+*                           before it [INPUT/OUTPUT]
+*               n           Number of squares in the path
+*               window      Steps of path searched again at a time
+*               margin      Squares searched around the window
+*
+* GLOBALS       -
+*
+* RETURNS       Number of squares left in the path, -1 on error
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         Every window of the path, overlapping by half, is
+*               searched again breadth-first within the bounding box of
+*               its squares grown by the margin, and replaced by the
+*               shortest connection of its ends found there. A window
+*               whose ends are as many steps apart as the straight
+*               distance between them is already shortest and is skipped.
+*               The passes are repeated until none shortens the path. The
+*               ends of the path stay.
+*
+*               A box has at most (w / 2 + 1 + 2 * margin)^2 squares for a
+*               window of w steps, so a pass is linear in the path length.
+*               The windows reach across the cluster borders and remove
+*               the detours through the entrances. In an open room the
+*               result is a shortest path. Elsewhere it is shortest unless
+*               a shorter way leaves every box along the path.
+*
+\**************************************************************************/
+
+int hpa_smooth(const char *maze, mazeparam_t *mazeparam, int *path, int n,
+               int window, int margin)
+{
+  int side = window + 1 + 2 * margin;
+  int *dist = (int *) malloc(2 * (size_t) side * side * sizeof (int));
+  int *seg = (int *) malloc((window + 1) * sizeof (int));
+  int *queue;
+  int changed = 1;
+  if ((dist == NULL) || (seg == NULL)) {
+    fprintf(stderr, "Cannot allocate memory for HPA* path smoothing.\n");
+    free(dist);
+    free(seg);
+    return (-1);
+  }
+  queue = dist + side * side;
+  while (changed) {
+    changed = 0;
+    for (int i = 0; i + 1 < n; i += window / 2) {
+      int j = (i + window < n - 1) ? i + window : n - 1;
+      int top = INT_MAX, left = INT_MAX, bottom = -1, right = -1;
+      int row, col, erow, ecol, w, h, d, head = 0, tail = 0;
+      for (int k = i; k <= j; k++) {
+        ROWCOL(path [k], row, col);
+        if (row < top) top = row;
+        if (row > bottom) bottom = row;
+        if (col < left) left = col;
+        if (col > right) right = col;
+      }
+      ROWCOL(path [i], row, col);
+      ROWCOL(path [j], erow, ecol);
+      if (abs(row - erow) + abs(col - ecol) == j - i) continue;   /* Already shortest */
+      top = (top > margin) ? top - margin : 0;
+      left = (left > margin) ? left - margin : 0;
+      bottom = (bottom + margin < mazeparam -> rows) ? bottom + margin : mazeparam -> rows - 1;
+      right = (right + margin < mazeparam -> cols) ? right + margin : mazeparam -> cols - 1;
+      w = right - left + 1;
+      h = bottom - top + 1;
+      for (int q = 0; q < w * h; q++) dist [q] = -1;
+      dist [(erow - top) * w + (ecol - left)] = 0;
+      queue [tail ++] = (erow - top) * w + (ecol - left);
+      while (head < tail) {
+        int q = queue [head ++];
+        for (int hd = 0; hd < 4; hd++) {
+          int nrow = q / w + headingrow [hd];
+          int ncol = q % w + headingcol [hd];
+          if (   (nrow < 0) || (nrow >= h) || (ncol < 0) || (ncol >= w)
+              || (dist [nrow * w + ncol] != -1)
+              || ! walkable(maze, mazeparam, top + nrow, left + ncol)) continue;
+          dist [nrow * w + ncol] = dist [q] + 1;
+          queue [tail ++] = nrow * w + ncol;
+        }
+      }
+      d = dist [(row - top) * w + (col - left)];
+      if (d >= j - i) continue;
+      seg [0] = path [i];
+      for (int k = 1; k <= d; k++) {   /* Down the distances to path [j] */
+        for (int hd = 0; hd < 4; hd++) {
+          int nrow = row - top + headingrow [hd];
+          int ncol = col - left + headingcol [hd];
+          if (   (nrow >= 0) && (nrow < h) && (ncol >= 0) && (ncol < w)
+              && (dist [nrow * w + ncol] == d - k)) {
+            row = top + nrow;
+            col = left + ncol;
+            break;
+          }
+        }
+        seg [k] = (int) LIN(row, col);
+      }
+      memcpy(path + i, seg, (d + 1) * sizeof (int));
+      memmove(path + i + d + 1, path + j + 1, (n - j - 1) * sizeof (int));
+      n -= j - i - d;
+      changed = 1;
+    }
+  }
+  free(dist);
+  free(seg);
+  return (n);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      hpa
+*
+* DESCRIPTION   Hierarchical A* (HPA*) maze traversing algorithm
+*
+* ARGUMENTS     pentti      The current position and state
+*               maze        The maze map [INPUT]
+*               mazeparam   The maze parameter struct
+*
+* GLOBALS       -
+*
+* RETURNS       Error code (0 == Success)
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*               2026 10 18   JPT   Snapshots by an observer
+*               2026 10 18   JPT   Path smoothing
+*
+* NOTES         Runs on mazeparam -> hpa, attached by solvemaze(). The
+*               start square and the squares next to the exits are
+*               linked to the nodes of their clusters by hpa_bfs() as
+*               temporary nodes numbered after the entrances: the start
+*               as graph -> nodes and the goals after it. A* as in astar()
+*               then searches the abstract graph, and every abstract edge
+*               of the result is refined into squares by one more search
+*               within its cluster. The squares are then shortened by
+*               hpa_smooth() over windows of HPA_SMOOTH_WINDOW cluster
+*               sides before they are marked as the path.
+*
+*               Only the abstract nodes get the exploration markers, and
+*               the pentti -> steps counter counts their expansions.
+*
+\**************************************************************************/
+
+int hpa(pentti_t *pentti, const char *maze, mazeparam_t *mazeparam)
+{
+  solve_t     solve;
+  observer_t  snapshots;
+  hpa_graph_t *graph = mazeparam -> hpa;
+  int         area, ids, source, ngoals = 0;
+  int         goal [4 * MAX_EXITS];
+  int         *goaldist [4 * MAX_EXITS];   /* To the nodes of the cluster */
+  int         *startdist = NULL;           /* Nodes, then goals */
+  int         *dist = NULL, *queue = NULL, *parent = NULL;
+  int         *path = NULL;                /* Refined squares, goal first */
+  int         npath = 0, pathcap = 0;
+  bitword_t   *closed = NULL;
+  int         found = -1, err = 0;
+  if (graph == NULL) return (1);
+  area = graph -> size * graph -> size;
+  for (int e = 0; e < mazeparam -> exits; e++) {
+    for (int h = 0; h < 4; h++) {
+      int row = mazeparam -> exitrow [e] + headingrow [h];
+      int col = mazeparam -> exitcol [e] + headingcol [h];
+      int dup = 0;
+      if (! walkable(maze, mazeparam, row, col)) continue;
+      for (int g = 0; g < ngoals; g++) dup |= (goal [g] == LIN(row, col));
+      if (! dup) goal [ngoals ++] = LIN(row, col);
+    }
+  }
+  source = graph -> nodes;
+  ids = graph -> nodes + 1 + ngoals;
+  dist = (int *) malloc(area * sizeof (int));
+  queue = (int *) malloc(area * sizeof (int));
+  parent = (int *) malloc(ids * sizeof (int));
+  closed = (bitword_t *) calloc(BITWORDS(ids), sizeof (bitword_t));
+  startdist = (int *) malloc((area + ngoals) * sizeof (int));
+  for (int g = 0; g < ngoals; g++) goaldist [g] = (int *) malloc(area * sizeof (int));
+  for (int g = 0; g < ngoals; g++) err |= (goaldist [g] == NULL);
+  if (   err || (dist == NULL) || (queue == NULL) || (parent == NULL)
+      || (closed == NULL) || (startdist == NULL)
+      || init_heap(&(mazeparam -> oheap), ids)) {
+    fprintf(stderr, "Cannot allocate memory for HPA* search layers.\n");
+    err = 1;
+  }
+  if (err == 0) {
+    int start = LIN(mazeparam -> startrow, mazeparam -> startcol);
+    int sc = hpa_cluster(graph, mazeparam, start);
+    int top = (sc / graph -> ccols) * graph -> size;
+    int left = (sc % graph -> ccols) * graph -> size;
+    int k = graph -> first [sc + 1] - graph -> first [sc];
+    fprintf(mazeparam -> out,
+            "HPA* graph has %d clusters and %d entrance nodes\n\n",
+            graph -> clusters, graph -> nodes);
+    hpa_bfs(graph, maze, mazeparam, start, dist, queue);
+    for (int i = 0; i < k + ngoals; i++) {
+      int square = (i < k) ? graph -> node [graph -> first [sc] + i] : goal [i - k];
+      int row, col;
+      ROWCOL(square, row, col);
+      startdist [i] = -1;
+      if (hpa_cluster(graph, mazeparam, square) == sc) {
+        startdist [i] = dist [(row - top) * graph -> size + (col - left)];
+      }
+    }
+    for (int g = 0; g < ngoals; g++) {
+      int gc = hpa_cluster(graph, mazeparam, goal [g]);
+      int gtop = (gc / graph -> ccols) * graph -> size;
+      int gleft = (gc % graph -> ccols) * graph -> size;
+      hpa_bfs(graph, maze, mazeparam, goal [g], dist, queue);
+      for (int i = graph -> first [gc]; i < graph -> first [gc + 1]; i++) {
+        int row, col;
+        ROWCOL(graph -> node [i], row, col);
+        goaldist [g] [i - graph -> first [gc]] =
+          dist [(row - gtop) * graph -> size + (col - gleft)];
+      }
+    }
+    for (int i = 0; i < ids; i++) parent [i] = -1;
+#define HPA_KEY(g,h) ((((long long) (g) + (h)) << 32) | (0xffffffffLL - (g)))
+#define HPA_RELAX(m,cost) {                                                 \
+      int mrow, mcol;                                                       \
+      long long mkey;                                                       \
+      ROWCOL(HPA_SQUARE(m), mrow, mcol);                                    \
+      mkey = HPA_KEY(g + (cost), heuristic(mazeparam, mrow, mcol));         \
+      if (   (! BIT_TEST(closed, (m)))                                      \
+          && (   (parent [m] == -1)                                         \
+              || (mkey < key_heap(&(mazeparam -> oheap), (m))))) {          \
+        insert_heap(&(mazeparam -> oheap), (m), mkey);                      \
+        parent [m] = id;                                                    \
+      }                                                                     \
+    }
+#define HPA_SQUARE(id) (((id) < source) ? graph -> node [id]               \
+                        : ((id) == source) ? start : goal [(id) - source - 1])
+    parent [source] = source;
+    insert_heap(&(mazeparam -> oheap), source,
+                HPA_KEY(0, heuristic(mazeparam, mazeparam -> startrow,
+                                     mazeparam -> startcol)));
+    init_solve(&solve, pentti, maze, mazeparam);
+    init_observer(&snapshots, 201, print_snapshot, NULL, NULL);
+    attach_observer(&solve, &snapshots);
+    pentti -> steps = 0;
+    while (mazeparam -> oheap.size) {
+      long long key;
+      int id = first_heap(&(mazeparam -> oheap), &key);
+      int g = (int) (0xffffffffLL - (key & 0xffffffffLL));
+      int idx = HPA_SQUARE(id);
+      int row, col, c;
+      delete_first_heap(&(mazeparam -> oheap));
+      BIT_SET(closed, id);
+      ROWCOL(idx, row, col);
+      set_pentti_at(pentti, maze, mazeparam, row, col);
+      mark_explored(mazeparam, idx, pentti -> steps);
+      if (pentti -> steps < solve.until) notify_observers(&solve);
+      if (id > source) {
+        found = id;
+        break;
+      }
+      if (id == source) {
+        for (int i = 0; i < k + ngoals; i++) {
+          int m = (i < k) ? graph -> first [sc] + i : source + 1 + i - k;
+          if (startdist [i] != -1) HPA_RELAX(m, startdist [i]);
+        }
+        continue;
+      }
+      c = hpa_cluster(graph, mazeparam, idx);
+      for (int h = 0; h < 4; h++) {
+        if (graph -> across [4 * id + h] != -1) HPA_RELAX(graph -> across [4 * id + h], 1);
+      }
+      for (int m = graph -> first [c]; m < graph -> first [c + 1]; m++) {
+        int d = graph -> dist [graph -> offset [c]
+                               + (size_t) (id - graph -> first [c])
+                                 * (graph -> first [c + 1] - graph -> first [c])
+                               + (m - graph -> first [c])];
+        if ((m != id) && (d != -1)) HPA_RELAX(m, d);
+      }
+      for (int j = 0; j < ngoals; j++) {
+        if (   (hpa_cluster(graph, mazeparam, goal [j]) == c)
+            && (goaldist [j] [id - graph -> first [c]] != -1)) {
+          HPA_RELAX(source + 1 + j, goaldist [j] [id - graph -> first [c]]);
+        }
+      }
+    }
+    for (int id = found; (id != -1) && (id != source); id = parent [id]) {
+      int from = HPA_SQUARE(parent [id]);
+      int idx = HPA_SQUARE(id);
+      int tc = hpa_cluster(graph, mazeparam, idx);
+      int ttop = (tc / graph -> ccols) * graph -> size;
+      int tleft = (tc % graph -> ccols) * graph -> size;
+      int d = 1;   /* Steps left to from, one across a border */
+      if (hpa_cluster(graph, mazeparam, from) == tc) {
+        hpa_bfs(graph, maze, mazeparam, from, dist, queue);
+      }
+      while (1) {
+        int row, col;
+        ROWCOL(idx, row, col);
+        if (hpa_cluster(graph, mazeparam, from) == tc) {
+          d = dist [(row - ttop) * graph -> size + (col - tleft)];
+        }
+        if (d == 0) break;   /* The start square as an entrance */
+        if (npath + 1 >= pathcap) {   /* One more for the start */
+          int cap = pathcap ? 2 * pathcap : 1024;
+          int *grown = (int *) realloc(path, cap * sizeof (int));
+          if (grown == NULL) {
+            err = 1;
+            break;
+          }
+          path = grown;
+          pathcap = cap;
+        }
+        path [npath ++] = idx;
+        if (d == 1) break;
+        for (int h = 0; h < 4; h++) {   /* Down the distances to from */
+          int prow = row + headingrow [h];
+          int pcol = col + headingcol [h];
+          if (   (! outside(mazeparam, prow, pcol))
+              && (hpa_cluster(graph, mazeparam, LIN(prow, pcol)) == tc)
+              && (dist [(prow - ttop) * graph -> size + (pcol - tleft)] == d - 1)) {
+            idx = LIN(prow, pcol);
+            break;
+          }
+        }
+      }
+      if (err) break;
+    }
+    if ((err == 0) && (found != -1)) {
+      if (npath == 0) path = (int *) malloc(sizeof (int));
+      if (path == NULL) err = 1;
+      else {
+        path [npath ++] = start;
+        npath = hpa_smooth(maze, mazeparam, path, npath,
+                           HPA_SMOOTH_WINDOW * graph -> size, graph -> size / 2);
+        if (npath == -1) err = 1;
+        for (int i = 0; i + 1 < npath; i++) mark_path(mazeparam, path [i]);
+      }
+    }
+    if (err && (npath != -1)) {
+      fprintf(stderr, "Cannot allocate memory for HPA* path.\n");
+    }
+#undef HPA_SQUARE
+#undef HPA_RELAX
+#undef HPA_KEY
+    free_heap(&(mazeparam -> oheap));
+  }
+  for (int g = 0; g < ngoals; g++) free(goaldist [g]);
+  free(path);
+  free(startdist);
+  free(dist);
+  free(queue);
+  free(parent);
+  free(closed);
+  if (err) return (1);
+  if (found == -1) {
+    fprintf(mazeparam -> out, "Exit not found after %lld steps\n\n", pentti -> steps);
+    return (SOLVE_NOT_FOUND);
+  }
+  fprintf(mazeparam -> out, "Final state at %lldth step\n\n", pentti -> steps);
+  printmaze(maze, mazeparam, 0);
+  fprintf(mazeparam -> out, "\n\n\n");
+  return (0);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      parallel_bfs_mark
+*
+* DESCRIPTION   Marks the squares reached by the parallel BFS so far
+*
+* ARGUMENTS     pool   The shared state of the search
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         Called between the layers only, when no thread reads the
+*               maze. The markers follow the distance layer as in
+*               bitboard().
+*
+\**************************************************************************/
+
+void parallel_bfs_mark(bfs_pool_t *pool)
+{
+  int mazesize = pool -> mazeparam -> rows * pool -> mazeparam -> cols;
+  for (int idx = 0; idx < mazesize; idx++) {
+    int d = pool -> distance [idx];
+    if (d == -1) continue;
+    mark_explored(pool -> mazeparam, idx, d);
+  }
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      parallel_bfs_marker
+*
+* DESCRIPTION   Observer marking the parallel BFS before a snapshot
+*
+* ARGUMENTS     observer   The observer, data pointing to the bfs_pool_t
+*               solve      The solve
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The threads claim the squares without marking them, so the
+*               layers are marked only when print_snapshot() is about to
+*               print them. Attach before it.
+*
+\**************************************************************************/
+
+void parallel_bfs_marker(observer_t *observer, solve_t *solve)
+{
+  if (snapshot_due(solve -> pentti -> steps)) {
+    parallel_bfs_mark((bfs_pool_t *) observer -> data);
+  }
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      parallel_bfs_worker
+*
+* DESCRIPTION   One thread of the level-synchronous parallel BFS
+*
+* ARGUMENTS     arg   Pointer to the bfs_work_t of the thread
+*
+* GLOBALS       -
+*
+* RETURNS       NULL
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*               2026 10 18   JPT   Observers of the layers
+*
+* NOTES         A layer has three phases separated by barriers. First every
+*               thread expands its slice of the frontier into its own local
+*               frontier, claiming the squares with an atomic or on the
+*               visited bitset; only the claiming thread writes the
+*               distance of a square. Then the local frontiers are copied
+*               side by side into the next frontier, each thread finding
+*               its offset from the sizes of the threads before it.
+*               Finally thread 0 swaps the frontiers, decides whether to
+*               go on and calls the observers of pool -> solve.
+*
+*               The threads wait at the gate mutex until the caller knows
+*               how many of them were started. The maze is only read here,
+*               so the threads share it freely.
+*
+\**************************************************************************/
+
+void *parallel_bfs_worker(void *arg)
+{
+  bfs_work_t  *work = (bfs_work_t *) arg;
+  bfs_pool_t  *pool = work -> pool;
+  mazeparam_t *mazeparam = pool -> mazeparam;
+  pthread_mutex_lock(&(pool -> gate));   /* Wait for the thread count */
+  pthread_mutex_unlock(&(pool -> gate));
+  while (1) {
+    int from = (int) ((long long) pool -> size * work -> thread / pool -> threads);
+    int to = (int) ((long long) pool -> size * (work -> thread + 1) / pool -> threads);
+    int offset = 0;
+    work -> size = 0;
+    for (int i = from; i < to; i++) {
+      int idx = pool -> frontier [i];
+      int row, col;
+      ROWCOL(idx, row, col);
+      for (int h = 0; h < 4; h++) {
+        int nrow = row + headingrow [h];
+        int ncol = col + headingcol [h];
+        int nidx = LIN(nrow, ncol);
+        bitword_t bit = 1ULL << (nidx & 63);
+        if (! walkable(pool -> maze, mazeparam, nrow, ncol)) continue;
+        if (__atomic_load_n(&(pool -> visited [nidx >> 6]), __ATOMIC_RELAXED) & bit) {
+          continue;
+        }
+        if (__atomic_fetch_or(&(pool -> visited [nidx >> 6]), bit, __ATOMIC_RELAXED) & bit) {
+          continue;   /* Claimed by another thread */
+        }
+        pool -> distance [nidx] = pool -> layer + 1;
+        if (nextto_exit(pool -> maze, mazeparam, nrow, ncol)) {
+          int goal = __atomic_load_n(&(pool -> goalidx), __ATOMIC_RELAXED);
+          while (   ((goal == -1) || (nidx < goal))
+                 && ! __atomic_compare_exchange_n(&(pool -> goalidx), &goal, nidx, 0,
+                                                  __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+        }
+        if (work -> size == work -> capacity) {
+          int *grown;
+          work -> capacity = work -> capacity ? 2 * work -> capacity : 1024;
+          grown = (int *) realloc(work -> local, work -> capacity * sizeof (int));
+          if (grown == NULL) {
+            work -> err = 1;
+            work -> capacity = work -> size;
+            continue;
+          }
+          work -> local = grown;
+        }
+        work -> local [work -> size ++] = nidx;
+      }
+    }
+    pthread_barrier_wait(&(pool -> barrier));
+    for (int t = 0; t < work -> thread; t++) offset += pool -> work [t].size;
+    if (work -> size) {
+      memcpy(pool -> next + offset, work -> local, work -> size * sizeof (int));
+    }
+    pthread_barrier_wait(&(pool -> barrier));
+    if (work -> thread == 0) {
+      int *swap = pool -> frontier;
+      pool -> frontier = pool -> next;
+      pool -> next = swap;
+      pool -> size = 0;
+      for (int t = 0; t < pool -> threads; t++) {
+        pool -> size += pool -> work [t].size;
+        pool -> done |= pool -> work [t].err;
+      }
+      pool -> layer ++;
+      if ((pool -> size == 0) || (pool -> goalidx != -1)) pool -> done = 1;
+      if (pool -> done == 0) {
+        pool -> solve -> pentti -> steps = pool -> layer;
+        if (pool -> layer < pool -> solve -> until) notify_observers(pool -> solve);
+      }
+    }
+    pthread_barrier_wait(&(pool -> barrier));
+    if (pool -> done) break;
+  }
+  return (NULL);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      parallel_bfs
+*
+* DESCRIPTION   Multi-threaded breadth-first maze traversing algorithm
+*
+* ARGUMENTS     pentti      The current position and state
+*               maze        The maze map [INPUT]
+*               mazeparam   The maze parameter struct
+*
+* GLOBALS       -
+*
+* RETURNS       Error code (0 == Success)
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*               2026 10 18   JPT   Snapshots by an observer
+*
+* NOTES         Level-synchronous: mazeparam -> threads threads, by default
+*               one per online processor, grow the frontier by a BFS layer
+*               at a time, see parallel_bfs_worker(). The calling thread
+*               works as the thread 0.
+*
+*               A step is a BFS layer, and the squares are marked by their
+*               distance layer as in bitboard(). Of the squares next to an
+*               exit in the first layer reaching one, the one with the
+*               smallest linear index is the goal, so the result does not
+*               depend on the thread timing.
+*
+\**************************************************************************/
+
+int parallel_bfs(pentti_t *pentti, const char *maze, mazeparam_t *mazeparam)
+{
+  int        mazesize = mazeparam -> rows * mazeparam -> cols;
+  int        start = LIN(mazeparam -> startrow, mazeparam -> startcol);
+  int        err = 0;
+  bfs_pool_t pool;
+  pthread_t  *tid;
+  solve_t    solve;
+  observer_t marker, snapshots;
+  memset(&pool, 0, sizeof (bfs_pool_t));
+  init_solve(&solve, pentti, maze, mazeparam);
+  init_observer(&marker, 201, parallel_bfs_marker, NULL, &pool);
+  init_observer(&snapshots, 201, print_snapshot, NULL, NULL);
+  attach_observer(&solve, &marker);
+  attach_observer(&solve, &snapshots);
+  pool.maze = maze;
+  pool.mazeparam = mazeparam;
+  pool.solve = &solve;
+  pool.threads = mazeparam -> threads ? mazeparam -> threads : cpu_count();
+  pool.goalidx = -1;
+  pthread_mutex_init(&pool.gate, NULL);
+  pool.distance = (int *) malloc(mazesize * sizeof (int));
+  pool.visited = (bitword_t *) calloc(BITWORDS(mazesize), sizeof (bitword_t));
+  pool.frontier = (int *) malloc(mazesize * sizeof (int));
+  pool.next = (int *) malloc(mazesize * sizeof (int));
+  pool.work = (bfs_work_t *) calloc(pool.threads, sizeof (bfs_work_t));
+  tid = (pthread_t *) malloc(pool.threads * sizeof (pthread_t));
+  if (   (pool.distance == NULL) || (pool.visited == NULL)
+      || (pool.frontier == NULL) || (pool.next == NULL)
+      || (pool.work == NULL) || (tid == NULL)) {
+    fprintf(stderr, "Cannot allocate memory for parallel BFS layers.\n");
+    err = 1;
+  }
+  if (err == 0) {
+    int started = 1;
+    memset(pool.distance, (unsigned char) 0xff, mazesize * sizeof (int));   /* -1 */
+    pool.distance [start] = 0;
+    BIT_SET(pool.visited, start);
+    pool.frontier [pool.size ++] = start;
+    if (nextto_exit(maze, mazeparam, mazeparam -> startrow, mazeparam -> startcol)) {
+      pool.goalidx = start;
+    }
+    for (int t = 0; t < pool.threads; t++) {
+      pool.work [t].pool = &pool;
+      pool.work [t].thread = t;
+    }
+    if (pool.goalidx == -1) {
+      pthread_mutex_lock(&pool.gate);   /* Held until the count is known */
+      for (; started < pool.threads; started++) {
+        if (pthread_create(&tid [started], NULL, parallel_bfs_worker,
+                           &pool.work [started])) break;
+      }
+      pool.threads = started;
+      pthread_barrier_init(&pool.barrier, NULL, pool.threads);
+      pthread_mutex_unlock(&pool.gate);
+      parallel_bfs_worker(&pool.work [0]);
+      for (int t = 1; t < started; t++) pthread_join(tid [t], NULL);
+      pthread_barrier_destroy(&pool.barrier);
+    }
+    for (int t = 0; t < started; t++) err |= pool.work [t].err;
+    if (err) fprintf(stderr, "Cannot allocate memory for parallel BFS frontier.\n");
+  }
+  if ((err == 0) && (pool.goalidx != -1)) {
+    int row, col;
+    parallel_bfs_mark(&pool);
+    ROWCOL(pool.goalidx, row, col);
+    set_pentti_at(pentti, maze, mazeparam, row, col);
+    while (pool.distance [LIN(row, col)] > 0) {
+      int idx = LIN(row, col);
+      int h;
+      mark_path(mazeparam, idx);
+      for (h = 0; h < 4; h++) {
+        int prow = row + headingrow [h];
+        int pcol = col + headingcol [h];
+        if (   (! outside(mazeparam, prow, pcol))
+            && (pool.distance [LIN(prow, pcol)] == pool.distance [idx] - 1)) break;
+      }
+      row += headingrow [h];
+      col += headingcol [h];
+    }
+  }
+  else if (err == 0) parallel_bfs_mark(&pool);
+  pentti -> steps = pool.layer;
+  for (int t = 0; pool.work && (t < pool.threads); t++) free(pool.work [t].local);
+  free(pool.work);
+  free(pool.distance);
+  free(pool.visited);
+  free(pool.frontier);
+  free(pool.next);
+  free(tid);
+  pthread_mutex_destroy(&pool.gate);
+  if (err) return (1);
+  if (pool.goalidx == -1) {
+    fprintf(mazeparam -> out, "Exit not found after %lld steps\n\n", pentti -> steps);
+    return (SOLVE_NOT_FOUND);
+  }
+  fprintf(mazeparam -> out, "Final state at %lldth step\n\n", pentti -> steps);
+  printmaze(maze, mazeparam, 0);
+  fprintf(mazeparam -> out, "\n\n\n");
+  return (0);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      open_tilestore
+*
+* DESCRIPTION   Opens a binary maze for tiled solving
+*
+* ARGUMENTS     store       The tile store [OUTPUT]
+*               filename    The name of a binary maze file
+*               size        Side of a square tile
+*               slots       Tiles held in memory at a time
+*
+* GLOBALS       -
+*
+* RETURNS       Error code (0 == Success)
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         Only the header of the maze is read here. The search state
+*               goes to an unlinked scratch file in $TMPDIR, or in /tmp,
+*               which grows sparsely as tiles are written back.
+*
+*               Release with close_tilestore(), also after an error.
+*
+\**************************************************************************/
+
+int open_tilestore(tilestore_t *store, char *filename, int size, int slots)
+{
+  unsigned char header [MAZEBIN_HEADER];
+  mazeparam_t   *mazeparam = &(store -> param);
+  const char    *tmpdir = getenv("TMPDIR");
+  char          scratch [PATH_MAX];
+  long long     tilerows;
+  memset(store, 0, sizeof (tilestore_t));
+  store -> statefd = -1;
+  store -> fd = open(filename, O_RDONLY);
+  if (store -> fd == -1) {
+    perror("Cannot open input file");
+    return (1);
+  }
+  if (   (pread(store -> fd, header, MAZEBIN_HEADER, 0) != MAZEBIN_HEADER)
+      || (memcmp(header, MAZEBIN_MAGIC, 4) != 0)) {
+    fprintf(stderr, "Out of core solving needs a binary maze, "
+            "convert %s with maze_convert.\n", filename);
+    return (1);
+  }
+  if (get_u32(header + 4) != MAZEBIN_VERSION) {
+    fprintf(stderr, "Unsupported binary maze version.\n");
+    return (1);
+  }
+  mazeparam -> rows = (int) get_u32(header + 8);
+  mazeparam -> cols = (int) get_u32(header + 12);
+  mazeparam -> startrow = (int) get_u32(header + 16);
+  mazeparam -> startcol = (int) get_u32(header + 20);
+  mazeparam -> exits = (int) get_u32(header + 24);
+  if (   (mazeparam -> rows <= 0) || (mazeparam -> cols <= 0)
+      || (mazeparam -> exits < 0) || (mazeparam -> exits > MAX_EXITS)
+      || outside(mazeparam, mazeparam -> startrow, mazeparam -> startcol)) {
+    fprintf(stderr, "Corrupt binary maze header.\n");
+    return (1);
+  }
+  for (int e = 0; e < mazeparam -> exits; e++) {
+    mazeparam -> exitrow [e] = (int) get_u32(header + 28 + 4 * e);
+    mazeparam -> exitcol [e] = (int) get_u32(header + 28 + 4 * (MAX_EXITS + e));
+  }
+  store -> size = size;
+  store -> slots = slots;
+  tilerows = (mazeparam -> rows + size - 1) / size;
+  store -> tilecols = (mazeparam -> cols + size - 1) / size;
+  store -> tiles = tilerows * store -> tilecols;
+  store -> slot = (tileslot_t *) calloc(slots, sizeof (tileslot_t));
+  store -> slotof = (int *) malloc(store -> tiles * sizeof (int));
+  store -> stored = (bitword_t *) calloc(BITWORDS(store -> tiles), sizeof (bitword_t));
+  if ((store -> slot == NULL) || (store -> slotof == NULL) || (store -> stored == NULL)) {
+    fprintf(stderr, "Cannot allocate memory for tile cache.\n");
+    return (1);
+  }
+  memset(store -> slotof, (unsigned char) 0xff, store -> tiles * sizeof (int));
+  for (int i = 0; i < slots; i++) {
+    store -> slot [i].tile = -1;
+    store -> slot [i].prev = i - 1;
+    store -> slot [i].next = (i + 1 < slots) ? i + 1 : -1;
+    store -> slot [i].wall = (unsigned char *) malloc(2 * (size_t) size * size);
+    if (store -> slot [i].wall == NULL) {
+      fprintf(stderr, "Cannot allocate memory for tile cache.\n");
+      return (1);
+    }
+    store -> slot [i].state = store -> slot [i].wall + (size_t) size * size;
+  }
+  store -> mru = 0;
+  store -> lru = slots - 1;
+  snprintf(scratch, sizeof (scratch), "%s/maze_tiles_XXXXXX",
+           tmpdir ? tmpdir : "/tmp");
+  store -> statefd = mkstemp(scratch);
+  if (store -> statefd == -1) {
+    perror("Cannot create tile state file");
+    return (1);
+  }
+  unlink(scratch);
+  return (0);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      close_tilestore
+*
+* DESCRIPTION   Releases a tile store
+*
+* ARGUMENTS     store   The tile store
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The scratch file disappears when closed.
+*
+\**************************************************************************/
+
+void close_tilestore(tilestore_t *store)
+{
+  if (store -> slot) {
+    for (int i = 0; i < store -> slots; i++) free(store -> slot [i].wall);
+  }
+  free(store -> slot);
+  free(store -> slotof);
+  free(store -> stored);
+  if (store -> fd != -1) close(store -> fd);
+  if (store -> statefd != -1) close(store -> statefd);
+  store -> slot = NULL;
+  store -> slotof = NULL;
+  store -> stored = NULL;
+  store -> fd = -1;
+  store -> statefd = -1;
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      load_tile_walls
+*
+* DESCRIPTION   Reads the walls of a tile from the binary maze
+*
+* ARGUMENTS     store   The tile store
+*               slot    The slot receiving the tile
+*               tile    The tile number
+*
+* GLOBALS       headingrow, headingcol
+*
+* RETURNS       Error code (0 == Success)
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The wall plane is stored row by row, so a tile is read as
+*               one short run of bytes per square row. The exits and the
+*               squares beyond the maze edge are set as walls too.
+*
+\**************************************************************************/
+
+int load_tile_walls(tilestore_t *store, tileslot_t *slot, long long tile)
+{
+  mazeparam_t   *mazeparam = &(store -> param);
+  int           size = store -> size;
+  int           row0 = (int) (tile / store -> tilecols) * size;
+  int           col0 = (int) (tile % store -> tilecols) * size;
+  int           width = (mazeparam -> cols - col0 < size) ? mazeparam -> cols - col0 : size;
+  unsigned char buf [TILE_SIZE / 8 + 2];
+  unsigned char *bits = (size <= TILE_SIZE) ? buf : (unsigned char *) malloc(size / 8 + 2);
+  if (bits == NULL) {
+    fprintf(stderr, "Cannot allocate memory for tile walls.\n");
+    return (1);
+  }
+  memset(slot -> wall, 1, (size_t) size * size);
+  for (int r = 0; (r < size) && (row0 + r < mazeparam -> rows); r++) {
+    long long first = LIN(row0 + r, col0);
+    long long last = first + width - 1;
+    size_t    n = (size_t) ((last >> 3) - (first >> 3) + 1);
+    if (pread(store -> fd, bits, n, MAZEBIN_HEADER + (first >> 3)) != (ssize_t) n) {
+      perror("Cannot read binary maze");
+      if (bits != buf) free(bits);
       return (1);
     }
-    mazeparam -> rows ++;
+    for (int c = 0; c < width; c++) {
+      int bit = (int) (first & 7) + c;
+      slot -> wall [r * size + c] = (bits [bit >> 3] >> (bit & 7)) & 1;
+    }
+  }
+  for (int e = 0; e < mazeparam -> exits; e++) {
+    int r = mazeparam -> exitrow [e] - row0;
+    int c = mazeparam -> exitcol [e] - col0;
+    if ((r >= 0) && (r < size) && (c >= 0) && (c < size)) slot -> wall [r * size + c] = 1;
+  }
+  if (bits != buf) free(bits);
+  return (0);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      tile_slot
+*
+* DESCRIPTION   Brings a tile into the cache
+*
+* ARGUMENTS     store   The tile store
+*               tile    The tile number
+*
+* GLOBALS       -
+*
+* RETURNS       The slot holding the tile, NULL on error
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         A cached tile becomes the most recently used one. Otherwise
+*               the least recently used slot is reused, and its state is
+*               written back to the scratch file first if it has changed.
+*               A tile never written back starts unreached.
+*
+\**************************************************************************/
+
+tileslot_t *tile_slot(tilestore_t *store, long long tile)
+{
+  size_t     bytes = (size_t) store -> size * store -> size;
+  int        i = store -> slotof [tile];
+  tileslot_t *slot;
+  if (i == -1) {
+    i = store -> lru;
+    slot = &(store -> slot [i]);
+    if (slot -> tile != -1) {
+      if (slot -> dirty) {
+        if (pwrite(store -> statefd, slot -> state, bytes,
+                   (off_t) slot -> tile * bytes) != (ssize_t) bytes) {
+          perror("Cannot write tile state");
+          return (NULL);
+        }
+        BIT_SET(store -> stored, slot -> tile);
+        store -> writes ++;
+      }
+      store -> slotof [slot -> tile] = -1;
+    }
+    slot -> tile = -1;
+    if (load_tile_walls(store, slot, tile)) return (NULL);
+    if (BIT_TEST(store -> stored, tile)) {
+      if (pread(store -> statefd, slot -> state, bytes,
+                (off_t) tile * bytes) != (ssize_t) bytes) {
+        perror("Cannot read tile state");
+        return (NULL);
+      }
+    }
+    else memset(slot -> state, 0, bytes);
+    slot -> tile = tile;
+    slot -> dirty = 0;
+    store -> slotof [tile] = i;
+    store -> loads ++;
+  }
+  slot = &(store -> slot [i]);
+  if (i != store -> mru) {
+    store -> slot [slot -> prev].next = slot -> next;
+    if (slot -> next != -1) store -> slot [slot -> next].prev = slot -> prev;
+    else store -> lru = slot -> prev;
+    slot -> prev = -1;
+    slot -> next = store -> mru;
+    store -> slot [store -> mru].prev = i;
+    store -> mru = i;
+  }
+  return (slot);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      tilecand_compare
+*
+* DESCRIPTION   qsort() comparison of frontier squares in tile order
+*
+* ARGUMENTS     a   Pointer to the first tilecand_t
+*               b   Pointer to the second tilecand_t
+*
+* GLOBALS       -
+*
+* RETURNS       Negative, zero or positive as in strcmp()
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         -
+*
+\**************************************************************************/
+
+int tilecand_compare(const void *a, const void *b)
+{
+  const tilecand_t *x = (const tilecand_t *) a;
+  const tilecand_t *y = (const tilecand_t *) b;
+  if (x -> tile != y -> tile) return ((x -> tile > y -> tile) ? 1 : -1);
+  return ((x -> cell > y -> cell) - (x -> cell < y -> cell));
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      tiled_bfs
+*
+* DESCRIPTION   Out of core breadth-first search of a binary maze
+*
+* ARGUMENTS     filename    The name of a binary maze file
+*               out         Destination of the printed results
+*               size        Side of a square tile
+*               slots       Tiles held in memory at a time
+*
+* GLOBALS       headingrow, headingcol
+*
+* RETURNS       Error code (0 == Success)
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The walls and the search state live in tiles paged through
+*               the cache of tile_slot(), and only the frontier is kept in
+*               memory. Each layer is sorted by tile, so every tile with
+*               frontier squares is brought in once per layer and the
+*               tiles are visited in file order. A square is claimed when
+*               its own tile is processed, which is where its wall and
+*               state are at hand.
+*
+*               The maze is never held whole, so it is not drawn; the path
+*               length is the layer of the first square next to an exit,
+*               and it is verified by following the arrival headings back
+*               to the start.
+*
+\**************************************************************************/
+
+int tiled_bfs(char *filename, FILE *out, int size, int slots)
+{
+  tilestore_t store;
+  mazeparam_t *mazeparam = &(store.param);
+  tilecand_t  *cur = NULL, *next = NULL;
+  long long   ncur = 0, nnext = 0, curcap = 1024, nextcap = 1024;
+  long long   layer = 0, goal = -1, pathlen = 0;
+  int         rv = 0;
+  if (open_tilestore(&store, filename, size, slots)) {
+    close_tilestore(&store);
+    return (1);
+  }
+  fprintf(out, "Maze %s, size %d x %d.\n\n", filename, mazeparam -> cols, mazeparam -> rows);
+  cur = (tilecand_t *) malloc(curcap * sizeof (tilecand_t));
+  next = (tilecand_t *) malloc(nextcap * sizeof (tilecand_t));
+  if ((cur == NULL) || (next == NULL)) {
+    fprintf(stderr, "Cannot allocate memory for tiled frontier.\n");
+    rv = 1;
+  }
+  else {
+    int row = mazeparam -> startrow, col = mazeparam -> startcol;
+    cur [0].tile = (row / size) * store.tilecols + col / size;
+    cur [0].cell = (row % size) * size + col % size;
+    cur [0].heading = 4;
+    ncur = 1;
+  }
+  while ((rv == 0) && ncur && (goal == -1)) {
+    qsort(cur, ncur, sizeof (tilecand_t), tilecand_compare);
+    nnext = 0;
+    for (long long k = 0; (k < ncur) && (rv == 0); k++) {
+      tileslot_t *slot = tile_slot(&store, cur [k].tile);
+      int        cell = cur [k].cell;
+      int        row, col;
+      if (slot == NULL) {
+        rv = 1;
+        break;
+      }
+      if (slot -> state [cell] || slot -> wall [cell]) continue;
+      slot -> state [cell] = (unsigned char) (1 + cur [k].heading);
+      slot -> dirty = 1;
+      row = (int) (cur [k].tile / store.tilecols) * size + cell / size;
+      col = (int) (cur [k].tile % store.tilecols) * size + cell % size;
+      for (int e = 0; e < mazeparam -> exits; e++) {
+        if (abs(mazeparam -> exitrow [e] - row) + abs(mazeparam -> exitcol [e] - col) == 1) {
+          goal = LIN(row, col);
+        }
+      }
+      if (goal != -1) break;
+      for (int h = 0; h < 4; h++) {
+        int nrow = row + headingrow [h];
+        int ncol = col + headingcol [h];
+        if (outside(mazeparam, nrow, ncol)) continue;
+        if (nnext == nextcap) {
+          tilecand_t *grown =
+            (tilecand_t *) realloc(next, 2 * nextcap * sizeof (tilecand_t));
+          if (grown == NULL) {
+            fprintf(stderr, "Cannot allocate memory for tiled frontier.\n");
+            rv = 1;
+            break;
+          }
+          next = grown;
+          nextcap *= 2;
+        }
+        next [nnext].tile = (nrow / size) * store.tilecols + ncol / size;
+        next [nnext].cell = (nrow % size) * size + ncol % size;
+        next [nnext].heading = h;
+        nnext ++;
+      }
+    }
+    if ((goal == -1) && (rv == 0)) {
+      tilecand_t *swap = cur;
+      long long  swapcap = curcap;
+      cur = next;
+      curcap = nextcap;
+      next = swap;
+      nextcap = swapcap;
+      ncur = nnext;
+      layer ++;
+    }
+  }
+  if ((rv == 0) && (goal != -1)) {
+    int row = (int) (goal / mazeparam -> cols);
+    int col = (int) (goal % mazeparam -> cols);
+    while (rv == 0) {
+      long long  tile = (row / size) * store.tilecols + col / size;
+      tileslot_t *slot = tile_slot(&store, tile);
+      int        heading;
+      if (slot == NULL) {
+        rv = 1;
+        break;
+      }
+      heading = slot -> state [(row % size) * size + col % size] - 1;
+      if (heading == 4) break;
+      row -= headingrow [heading];
+      col -= headingcol [heading];
+      pathlen ++;
+    }
+  }
+  fprintf(out, "Tiled search of %lld tiles of %d x %d squares, "
+          "%lld tile loads, %lld write-backs\n\n",
+          store.tiles, size, size, store.loads, store.writes);
+  if (rv == 0) {
+    if (goal == -1) {
+      fprintf(out, "Exit not found after %lld layers\n\n", layer);
+      rv = SOLVE_NOT_FOUND;
+    }
+    else if (pathlen != layer) {
+      fprintf(stderr, "Tiled search path of %lld steps is broken.\n", pathlen);
+      rv = 1;
+    }
+    else fprintf(out, "Solution, path has %lld steps\n\n\n\n", pathlen);
+  }
+  free(cur);
+  free(next);
+  close_tilestore(&store);
+  return (rv);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      cellmask_layer
+*
+* DESCRIPTION   Builds the wall mask layer of a loaded maze
+*
+* ARGUMENTS     maze        The maze map [INPUT/OUTPUT]
+*               mazeparam   The maze parameter struct
+*
+* GLOBALS       -
+*
+* RETURNS       Error code (0 == Success)
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The layer has a byte for each square of the maze and of a
+*               ring of sentinel squares around it, see PADLIN(). The bit
+*               h (0 east ... 3 south) of a byte tells that the neighbour
+*               of the heading h is walkable, CELL_WALKABLE that the square
+*               itself is, CELL_EXIT that it is an exit and CELL_NEXTTO_EXIT
+*               that an exit is next to it. The sentinels are all zeros,
+*               so testing a square for walls and goals takes a single
+*               load and a mask, without bounds checking.
+*
+*               The layer is allocated after the squares in the block of
+*               the maze map, which is reallocated, and mazeparam ->
+*               cellmask points to it. Freeing the maze frees the layer.
+*               The layer describes the maze alone: solvers reading the
+*               markers of their overlay must read them separately.
+*
+\**************************************************************************/
+
+int cellmask_layer(char **maze, mazeparam_t *mazeparam)
+{
+  long long     mazesize = (long long) mazeparam -> rows * mazeparam -> cols;
+  long long     padsize = ((long long) mazeparam -> rows + 2) * (mazeparam -> cols + 2);
+  long long     offset [4];
+  char          *grown = (char *) realloc(*maze, (size_t) (mazesize + padsize));
+  unsigned char *mask;
+  if (grown == NULL) {
+    fprintf(stderr, "Cannot allocate memory for wall mask layer.\n");
+    return (1);
+  }
+  *maze = grown;
+  mask = (unsigned char *) grown + mazesize;
+  memset(mask, 0, (size_t) padsize);
+  for (int h = 0; h < 4; h++) {
+    offset [h] = (long long) headingrow [h] * (mazeparam -> cols + 2) + headingcol [h];
+  }
+  for (int row = 0; row < mazeparam -> rows; row++) {
+    const char    *m = grown + LIN(row, 0);
+    unsigned char *c = mask + PADLIN(row, 0);
+    for (int col = 0; col < mazeparam -> cols; col++) {
+      if (m [col] == 'E') c [col] = CELL_EXIT;
+      else if (m [col] != '#') c [col] = CELL_WALKABLE;
+    }
+  }
+  for (int row = 0; row < mazeparam -> rows; row++) {
+    unsigned char *c = mask + PADLIN(row, 0);
+    for (int col = 0; col < mazeparam -> cols; col++) {
+      for (int h = 0; h < 4; h++) {
+        unsigned char n = c [col + offset [h]];
+        if (n & CELL_WALKABLE) c [col] |= (unsigned char) (1 << h);
+        if (n & CELL_EXIT) c [col] |= CELL_NEXTTO_EXIT;
+      }
+    }
+  }
+  mazeparam -> cellmask = mask;
+  return (0);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      mazeinit
+*
+* DESCRIPTION   Maze allocation, initialization and sanity check
+*
+* ARGUMENTS     filename    Maze file name
+*               maze        The maze map
+*               mazeparam   The maze parameter struct
+*
+* GLOBALS       -
+*
+* RETURNS       Error code (0 == Success)
+*
+* HISTORY       2023 01 01   JPT   First implementation
+*               2026 10 18   JPT   Output to stdout by default
+*               2026 10 18   JPT   No marker overlay until init_overlay()
+*               2026 10 18   JPT   Single pass loading by mapmaze()
+*               2026 10 18   JPT   Wall mask layer
+*               2026 10 18   JPT   No walker budget by default
+*
+* NOTES         IMPORTANT: Allocates memory via mapmaze(). Freeing
+*               allocated memory is necessary if mazeinit() returns 0
+*               meaning successful completion.
+*
+*               The maze map is followed by the wall mask layer of
+*               cellmask_layer() in the same block.
+*
+\**************************************************************************/
+
+int mazeinit (char *filename, char **maze, mazeparam_t *mazeparam) {
+  int errcode;
+  mazeparam -> olist = NULL;
+  mazeparam -> out = stdout;
+  mazeparam -> overlay = NULL;
+  memset(&(mazeparam -> budget), 0, sizeof (budget_t));
+  errcode = mapmaze(filename, maze, NULL, mazeparam);
+  if (errcode) return (1);
+  errcode = wall_sanity(*maze, mazeparam, 1);
+  if (errcode == 0) errcode = cellmask_layer(maze, mazeparam);
+  if (errcode) {free(*maze); *maze = NULL; return (1);}
+  return (0);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      mazeinit_rle
+*
+* DESCRIPTION   Maze initialization into run-length encoded rows
+*
+* ARGUMENTS     filename    Maze file name
+*               rle         The run-length rows [OUTPUT]
+*               mazeparam   The maze parameter struct
+*
+* GLOBALS       -
+*
+* RETURNS       Error code (0 == Success)
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*               2026 10 18   JPT   No walker budget by default
+*
+* NOTES         As mazeinit(), but the maze is kept as run-length rows,
+*               which mazeparam -> rle points to, and there is no maze
+*               map: the solvers are passed NULL for it. Mostly open
+*               mazes take a fraction of the memory of the map this way,
+*               but every square lookup is a binary search of its row.
+*               No wall mask layer is built, as it would take a byte per
+*               square again.
+*
+*               IMPORTANT: Allocates memory via mapmaze(). Release it with
+*               free_rle() if mazeinit_rle() returns 0.
+*
+\**************************************************************************/
+
+int mazeinit_rle(char *filename, rlemaze_t *rle, mazeparam_t *mazeparam)
+{
+  char *maze = NULL;
+  mazeparam -> olist = NULL;
+  mazeparam -> out = stdout;
+  mazeparam -> overlay = NULL;
+  memset(&(mazeparam -> budget), 0, sizeof (budget_t));
+  memset(rle, 0, sizeof (rlemaze_t));
+  if (mapmaze(filename, &maze, rle, mazeparam)) return (1);
+  if (wall_sanity(maze, mazeparam, 1)) {
+    free_rle(rle);
+    return (1);
+  }
+  return (0);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      pathlength
+*
+* DESCRIPTION   Counts the squares marked as the solution path
+*
+* ARGUMENTS     maze        The maze map [INPUT]
+*               mazeparam   The maze parameter struct
+*
+* GLOBALS       -
+*
+* RETURNS       Number of path squares
+*
+* HISTORY       2026 10 18   JPT   Separated from solvemaze()
+*               2026 10 18   JPT   Markers from mazeparam -> overlay
+*               2026 10 18   JPT   64-bit count
+*
+* NOTES         Path squares are the uppercase markers 'A', 'B', 'C', 'O'
+*               of the overlay layer. The maze itself is not inspected.
+*
+\**************************************************************************/
+
+long long pathlength(const char *maze, mazeparam_t *mazeparam)
+{
+  long long mazesize = (long long) mazeparam -> rows * mazeparam -> cols;
+  long long pl = 0;
+  for (long long i = 0; i < mazesize; i++) {
+    if (mazeparam -> overlay [i] && strchr("ABCO", mazeparam -> overlay [i])) pl++;
+  }
+  return (pl);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      cached_maze
+*
+* DESCRIPTION   Returns the loaded maze of a cache, loading it once
+*
+* ARGUMENTS     cache       The cache of the maze file
+*               filename    The name of the maze file
+*               maze        The maze map [OUTPUT]
+*               mazeparam   The maze parameter struct [OUTPUT]
+*
+* GLOBALS       -
+*
+* RETURNS       Error code (0 == Success)
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*               2026 10 18   JPT   Run-length rows
+*
+* NOTES         The first run loads and checks the file by mazeinit() under
+*               the cache lock, and every run gets a copy of the harvested
+*               parameters. The maze must not be written to, as the runs
+*               may share it concurrently. A failed load is not retried.
+*
+*               With cache -> rle set, the file is loaded by mazeinit_rle()
+*               instead, the maze map is NULL and mazeparam -> rle points
+*               to the rows of the cache.
+*
+\**************************************************************************/
+
+int cached_maze(mazecache_t *cache, char *filename, const char **maze,
+                mazeparam_t *mazeparam)
+{
+  pthread_mutex_lock(&(cache -> lock));
+  if ((cache -> loaded == 0) && cache -> rle) {
+    cache -> loaded = mazeinit_rle(filename, &(cache -> runs), &(cache -> param)) ? -1 : 1;
+  }
+  if (cache -> loaded == 0) {
+    cache -> loaded = mazeinit(filename, &(cache -> maze), &(cache -> param)) ? -1 : 1;
+  }
+  pthread_mutex_unlock(&(cache -> lock));
+  if (cache -> loaded != 1) return (1);
+  *mazeparam = cache -> param;
+  *maze = cache -> maze;
+  return (0);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      solvemaze
+*
+* DESCRIPTION   Top level caller to invoke a single solving algorithm
+*
+* ARGUMENTS     solver     The chosen algorithm (a function pointer)
+*               filename   The name of the maze fiole to solve
+*               flags      Special requests (e.g. Pledge mode)
+*               cache      Graph cache of the maze file, NULL for none
+*               out        Destination of the printed results
+*
+* GLOBALS       -
+*
+* RETURNS       Error code (0 == Success)
+*
+* HISTORY       2023 01 01   JPT   First implementation
+*               2026 10 18   JPT   Graph cache and output stream
+*               2026 10 18   JPT   Shared maze and marker overlay
+*               2026 10 18   JPT   Square count check
+*               2026 10 18   JPT   Out of core solving
+*               2026 10 18   JPT   Walker budget and unsolvable mazes
+*               2026 10 18   JPT   No solution when the exit is not found
+*               2026 10 18   JPT   Threads of the run from the cache
+*
+* NOTES         The maze is loaded once per cache by cached_maze() and
+*               only read here; the solver marks its own overlay layer.
+*               Without a cache the maze and the graphs are loaded and
+*               built for this run only.
+*
+*               Most solvers index their square tables with an int, and
+*               only those flagged with LARGE_MAZES may run on a maze of
+*               more than INT_MAX squares. An OUT_OF_CORE algorithm never
+*               loads the maze; it reads the file tile by tile itself.
+*
+*               A solution is printed only when the solver finds the exit.
+*               Otherwise the status of the solver is returned, whether it
+*               refused the maze, did not find the exit or found the maze
+*               unsolvable.
+*
+\**************************************************************************/
+
+int solvemaze(solver_t solver, char *filename, int flags, mazecache_t *cache,
+              FILE *out) {
+  mazeparam_t mazeparam;
+  mazecache_t private;
+  const char  *maze = NULL;
+  pentti_t    pentti;
+  int rv = 0;
+  if (cache == NULL) {
+    init_mazecache(&private, 1);
+    cache = &private;
+  }
+  if (flags & OUT_OF_CORE) {
+    rv = tiled_bfs(filename, out, TILE_SIZE, TILE_CACHE_SLOTS);
+    if (cache == &private) release_mazecache(cache);
+    return (rv);
+  }
+  rv = cached_maze(cache, filename, &maze, &mazeparam);
+  if (   (rv == 0) && ! (flags & LARGE_MAZES)
+      && ((long long) mazeparam.rows * mazeparam.cols > INT_MAX)) {
+    fprintf(stderr, "Maze %s has more than %d squares, try the pledge "
+            "or wall follower algorithm.\n", filename, INT_MAX);
+    rv = 1;
   }
-  fclose(f);
-  return (0);
+  if (rv || init_overlay(&mazeparam)) {
+    if (cache == &private) release_mazecache(cache);
+    return (1);
+  }
+  mazeparam.out = out;
+  mazeparam.budget = cache -> budget;
+  mazeparam.pledge_enable = (int) ((flags & PLEDGE_ENABLE) != 0);
+  mazeparam.frontier = FRONTIER_HEAP;
+  if (flags & BUCKET_FRONTIER) mazeparam.frontier = FRONTIER_BUCKET;
+  if (flags & LIST_FRONTIER)   mazeparam.frontier = FRONTIER_LIST;
+  mazeparam.wall_heuristic = (int) ((flags & WALL_HEURISTIC) != 0);
+  mazeparam.graph = NULL;
+  if (flags & JUNCTION_GRAPH) {
+    mazeparam.graph = junction_graph(cache, maze, &mazeparam);
+  }
+  mazeparam.hpa = NULL;
+  mazeparam.threads = cache -> threads;
+  if (flags & HPA_GRAPH) mazeparam.hpa = hpa_graph(cache, maze, &mazeparam);
+  pentti.row   = mazeparam.startrow;
+  pentti.col   = mazeparam.startcol;
+  pentti.steps = 0;
+  fprintf(out, "Maze %s, size %d x %d.\n\n"
+          "Legend: A = up to 20 steps, B = up to 150 steps,\n"
+          "C = up to 200 steps, O = more than 200 steps\n\n",
+          filename, mazeparam.cols, mazeparam.rows);
+  rv = solver(&pentti, maze, &mazeparam);
+  if (rv == SOLVE_OK) {
+    fprintf(out, "Solution, path has %lld steps\n\n", pathlength(maze, &mazeparam));
+    printmaze(maze, &mazeparam, 1);
+    fprintf(out, "\n\n\n");
+  }
+  free_overlay(&mazeparam);
+  if (cache == &private) release_mazecache(cache);
+  return (rv);
 }
 
 
 
 /**************************************************************************\
 *
-* FUNCTION      loadmaze
+* TABLE         algorithms
 *
-* DESCRIPTION   Maze input loader
+* DESCRIPTION   The solving algorithms available to main()
 *
-* ARGUMENTS     filename    The name of the text file containing a maze
-*               maze        The maze map [OUTPUT]
-*               mazeparam   The maze parameter struct
+* HISTORY       2026 10 18   JPT   First implementation
 *
-* GLOBALS       -
+* NOTES         The classic entries reproduce the original three runs.
+*               The table ends with a NULL name.
 *
-* RETURNS       Error code (0 == Success)
+\**************************************************************************/
+
+algorithm_t algorithms [] = {
+  {"dijkstra",        "DIJKSTRA",           dijkstra,      0,                           1},
+  {"pledge",          "PLEDGE",             pledge,        PLEDGE_ENABLE | LARGE_MAZES, 1},
+  {"wallfollower",    "WALL FOLLOWER",      pledge,        LARGE_MAZES,                 1},
+  {"dijkstra-bucket", "DIJKSTRA (BUCKETS)", dijkstra,      BUCKET_FRONTIER,             0},
+  {"dijkstra-list",   "DIJKSTRA (LIST)",    dijkstra,      LIST_FRONTIER,               0},
+  {"bitboard",        "BITBOARD BFS",       bitboard,      0,                           0},
+  {"bidirectional",   "BIDIRECTIONAL BFS",  bidirectional, 0,                           0},
+  {"astar",           "A* (NEAREST EXIT)",  astar,         0,                           0},
+  {"astar-wall",      "A* (NEAREST WALL)",  astar,         WALL_HEURISTIC,              0},
+  {"jps",             "JUMP POINT SEARCH",  jps,           0,                           0},
+  {"junction",        "JUNCTION GRAPH",     junction,      JUNCTION_GRAPH,              0},
+  {"hpa",             "HIERARCHICAL A*",    hpa,           HPA_GRAPH,                   0},
+  {"parallel-bfs",    "PARALLEL BFS",       parallel_bfs,  0,                           0},
+  {"tiled-bfs",       "TILED BFS",          NULL,          OUT_OF_CORE | LARGE_MAZES,   0},
+  {NULL,              NULL,                 NULL,          0,                           0}
+};
+
+
+
+/**************************************************************************\
 *
-* HISTORY       2023 01 01   JPT   First implementation
+* FUNCTION      findalgorithm
 *
-* NOTES         Expects a sanity-checked maze!
+* DESCRIPTION   Looks up an algorithm by its command line name
 *
-*               IMPORTANT: Allocates heap memory!
+* ARGUMENTS     name   Algorithm name
+*
+* GLOBALS       algorithms
+*
+* RETURNS       Table entry, NULL if unknown
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         -
 *
 \**************************************************************************/
 
-int loadmaze(char *filename, char **maze, mazeparam_t *mazeparam)
+algorithm_t *findalgorithm(char *name)
 {
-  FILE *f = NULL;
-  char buf [MAX_ALLOWED_ROWLENGTH + 3];   /* Allow \r\n\0 at the end */
-  f = fopen(filename, "r");
-  if (f == NULL)
-  {
-    perror("Cannot open input file "
-           "(Previous open succeeded? Error in code?)");
-    return (1);
-  }
-  *maze = (char *) malloc(mazeparam -> cols * mazeparam -> rows);
-  if (*maze == NULL) {
-    fprintf(stderr, "Cannot allocate memory for maze.\n");
-    fclose(f);
-    return (1);
+  for (algorithm_t *a = algorithms; a -> name; a++) {
+    if (strcmp(a -> name, name) == 0) return (a);
   }
-  for (int r = 0 ; r < mazeparam -> rows ; r++) {
-    int len = 0;
-    (void) readln_stripped(f, buf, &len);
-    memcpy(*(maze) + r * mazeparam -> cols, buf, mazeparam -> cols);
-  }
-  fclose(f);
-  return (0);
+  return (NULL);
 }
 
 
-    
+
 /**************************************************************************\
 *
-* FUNCTION      endpoints
+* FUNCTION      runalgorithm
 *
-* DESCRIPTION   Maze path endpoint examination
+* DESCRIPTION   Prints the heading of an algorithm and solves the maze
 *
-* ARGUMENTS     maze        The maze map [OUTPUT]
-*               mazeparam   The maze parameter struct
+* ARGUMENTS     algorithm   Table entry of the algorithm
+*               filename    The name of the maze file to solve
+*               cache       Graph cache of the maze file, NULL for none
+*               out         Destination of the printed results
 *
 * GLOBALS       -
 *
 * RETURNS       Error code (0 == Success)
 *
-* HISTORY       2023 01 01   JPT   First implementation
+* HISTORY       2026 10 18   JPT   First implementation
 *
-* NOTES         Expects a correctly initialized mazeparam struct.
+* NOTES         The heading is padded with dashes to 40 characters.
 *
 \**************************************************************************/
 
-int endpoints (char *maze, mazeparam_t *mazeparam)
+int runalgorithm(algorithm_t *algorithm, char *filename, mazecache_t *cache,
+                 FILE *out)
 {
-  mazeparam -> exits = 0;
-  mazeparam -> startcategory = START_EDGE;
-  for (int row = 0; row < mazeparam -> rows; row++) {
-    for (int col = 0; col < mazeparam -> cols; col++) {
-      char ch = mazeval(maze, mazeparam, row, col);
-      if (ch == '^') {
-        mazeparam -> startrow = row;
-        mazeparam -> startcol = col;
-        if (   (row > 0) && (row < mazeparam -> rows - 1)
-            && (col > 0) && (col < mazeparam -> cols - 1)) {
-          mazeparam -> startcategory = START_INSIDE;
-        }
-      }
-      if (ch == 'E') {
-        if (mazeparam -> exits == MAX_EXITS + 1) {
-          fprintf(stderr, "Maximum number of exits (%d) exceeded.\n", MAX_EXITS);
-          free(maze);
-          return (1);
-        }
-        mazeparam -> exitrow [mazeparam -> exits] = row;
-        mazeparam -> exitcol [mazeparam -> exits] = col;
-        (mazeparam -> exits) ++;
-      }
-    }
-  }
-  return (0);
+  int pad = 40 - 6 - (int) strlen(algorithm -> title);
+  fprintf(out, "---- %s ", algorithm -> title);
+  for (int i = 0; i < pad; i++) fputc('-', out);
+  fprintf(out, "\n\n");
+  return (solvemaze(algorithm -> solver, filename, algorithm -> flags, cache, out));
 }
 
 
 
 /**************************************************************************\
 *
-* FUNCTION      wall_sanity
+* FUNCTION      add_mazefile
 *
-* DESCRIPTION   Checks the sanity of the external walls
+* DESCRIPTION   Appends maze file names to a batch file list
 *
-* ARGUMENTS     maze        The maze map [OUTPUT]
-*               mazeparam   The maze parameter struct
-*               abortflag   Flag to abort program at wall abnormality
+* ARGUMENTS     list       The file list [INPUT/OUTPUT]
+*               path       A maze file or a directory of maze files
 *
 * GLOBALS       -
 *
-* RETURNS       Sanity flag (0 == OK)
+* RETURNS       Error code (0 == Success)
 *
-* HISTORY       2023 01 01   JPT   First implementation
+* HISTORY       2026 10 18   JPT   First implementation
 *
-* NOTES         Offers a choice to correct errors.
+* NOTES         The regular files of a directory are added in alphabetical
+*               order, without descending into subdirectories.
 *
 \**************************************************************************/
 
-int wall_sanity(char *maze, mazeparam_t *mazeparam, int abortflag)
+int add_mazefile(filelist_t *list, char *path)
 {
-  int flag = 0;
-  for (int i = 0; i < mazeparam -> cols; i++) {
-    int north = i;
-    int south = mazeparam -> cols * (mazeparam -> rows - 1) + i;
-    flag = (int) ((maze [north] == ' ') || (maze [south] == ' '));
-    if (abortflag && (flag != 0)) return (1);
-    if (maze [north] == ' ') maze [north] = '#';
-    if (maze [south] == ' ') maze [south] = '#';
-  }
-  for (int i = 0; i < mazeparam -> rows; i++) {
-    int west = mazeparam -> cols * i;
-    int east = west + mazeparam -> cols - 1;
-    flag = (int) ((maze [west] == ' ') || (maze [east] == ' '));
-    if (abortflag && (flag != 0)) return (1);
-    if (maze [west] == ' ') maze [west] = '#';
-    if (maze [east] == ' ') maze [east] = '#';
-  }
-  /* The following are incorrectable */
-  if (   (mazeparam -> startrow == 0)
-      && (maze [LIN(1, mazeparam -> startcol)] == '#')) {
-    return (1);
-  }
-  if (   (mazeparam -> startrow == mazeparam -> rows - 1)
-      && (maze [LIN(mazeparam -> rows - 2, mazeparam -> startcol)] == '#')) {
-    return (1);
+  struct stat    st;
+  struct dirent **entries;
+  int            n, err = 0;
+  if ((stat(path, &st) != 0) || ! S_ISDIR(st.st_mode)) {
+    if (list -> files == list -> capacity) {
+      char **grown;
+      list -> capacity = list -> capacity ? 2 * list -> capacity : 64;
+      grown = (char **) realloc(list -> name, list -> capacity * sizeof (char *));
+      if (grown == NULL) {
+        fprintf(stderr, "Cannot allocate memory for file list.\n");
+        return (1);
+      }
+      list -> name = grown;
+    }
+    list -> name [list -> files] = strdup(path);
+    if (list -> name [list -> files] == NULL) return (1);
+    list -> files ++;
+    return (0);
   }
-  if (   (mazeparam -> startcol == 0)
-      && (maze [LIN(mazeparam -> startrow, 1)] == '#')) {
+  n = scandir(path, &entries, NULL, alphasort);
+  if (n < 0) {
+    fprintf(stderr, "Cannot read directory %s\n", path);
     return (1);
   }
-  if (   (mazeparam -> startcol == mazeparam -> cols - 1)
-      && (maze [LIN(mazeparam -> startrow, mazeparam -> cols - 2)] == '#')) {
-    return (1);
+  for (int i = 0; i < n; i++) {
+    char name [PATH_MAX];
+    if (   (snprintf(name, PATH_MAX, "%s/%s", path, entries [i] -> d_name) < PATH_MAX)
+        && (stat(name, &st) == 0) && S_ISREG(st.st_mode)) {
+      if (err == 0) err = add_mazefile(list, name);
+    }
+    free(entries [i]);
   }
-  return (0);
+  free(entries);
+  return (err);
 }
 
 
 
 /**************************************************************************\
 *
-* FUNCTION      printmaze
+* FUNCTION      read_manifest
 *
-* DESCRIPTION   Maze result printer
+* DESCRIPTION   Appends the maze files named in a manifest to a file list
 *
-* ARGUMENTS     maze        The maze map [INPUT]
-*               mazeparam   The maze parameter struct
-*               cleaned     Erasure of fruitless path branches
+* ARGUMENTS     list       The file list [INPUT/OUTPUT]
+*               manifest   Name of a file listing a path per line
 *
 * GLOBALS       -
 *
 * RETURNS       Error code (0 == Success)
 *
-* HISTORY       2023 01 01   JPT   First implementation
+* HISTORY       2026 10 18   JPT   First implementation
 *
-* NOTES         Expects a preloaded maze and valid mazeparams contents.
+* NOTES         Empty lines are skipped. A path may be a directory, see
+*               add_mazefile().
 *
 \**************************************************************************/
 
-int printmaze(char *maze, mazeparam_t *mazeparam, int cleaned)
+int read_manifest(filelist_t *list, char *manifest)
 {
-  char s [MAX_ALLOWED_ROWLENGTH + 3];
-  for (int r = 0; r < mazeparam -> rows; r++) {
-    memcpy(s, maze + mazeparam -> cols * r, mazeparam -> cols);
-    s [mazeparam -> cols] = '\0';
-    if (r == mazeparam -> startrow) s [mazeparam -> startcol] = '^';
-    if (cleaned) {
-      for (int c = 0; c < mazeparam -> cols; c++) {
-        if (strchr("abc.", s [c])) s [c] = ' ';
-      }
+  char buf [PATH_MAX];
+  FILE *f = fopen(manifest, "r");
+  if (f == NULL) {
+    fprintf(stderr, "Cannot open manifest %s\n", manifest);
+    return (1);
+  }
+  while (fgets(buf, PATH_MAX, f)) {
+    int len = (int) strcspn(buf, "\r\n");
+    buf [len] = '\0';
+    if (len == 0) continue;
+    if (add_mazefile(list, buf)) {
+      fclose(f);
+      return (1);
     }
-    printf("%s\n", s);
   }
+  fclose(f);
+  return (0);
 }
 
 
 
 /**************************************************************************\
 *
-* FUNCTION      checkside
+* FUNCTION      free_filelist
 *
-* DESCRIPTION   Blockage and parenthood of a potential next step
+* DESCRIPTION   Releases a batch file list
 *
-* ARGUMENTS     mazeparam   The maze parameter struct
-*               atval       Character value in the current maze square
-*               siderow     Row of the potential next step
-*               sidecol     Column of the potential next step
-*               atrow       Current row
-*               atcol       Current column
+* ARGUMENTS     list   The file list
 *
 * GLOBALS       -
 *
-* RETURNS       Access status (0 == Vacant)
+* RETURNS       -
 *
-* HISTORY       2023 01 01   JPT   First implementation
+* HISTORY       2026 10 18   JPT   First implementation
 *
-* NOTES         Used for different directions.
+* NOTES         -
 *
 \**************************************************************************/
 
-void checkside (mazeparam_t *mazeparam, char *maze, int *exclusion,
-                parent_data_t *parent_data,
-                char atval, int siderow, int sidecol, int atrow, int atcol)
+void free_filelist(filelist_t *list)
 {
-  int row, col;
-  if (mazeval(maze, mazeparam, siderow, sidecol) == '#') return;
-  if (exclusion_at (mazeparam, exclusion, siderow, sidecol)) return;
-  get_parent_data (parent_data, mazeparam, siderow, sidecol, &row, &col);
-  if ((row == -1) || (col == -1)) {
-    insert_unique(&(mazeparam -> olist), LIN(siderow, sidecol));
-    set_parent_data(parent_data, mazeparam, siderow, sidecol, atrow, atcol);
-  }
+  for (int i = 0; i < list -> files; i++) free(list -> name [i]);
+  free(list -> name);
+  memset(list, 0, sizeof (filelist_t));
 }
 
 
 
 /**************************************************************************\
 *
-* FUNCTION      dijkstra
+* FUNCTION      batch_next
 *
-* DESCRIPTION   Dijkstra's maze traversing algorithm
+* DESCRIPTION   Takes the next job for a batch thread
 *
-* ARGUMENTS     pentti      The current position and state
-*               maze        The maze map [INPUT]
-*               mazeparam   The maze parameter struct
+* ARGUMENTS     batch    The batch
+*               thread   Number of the asking thread
 *
 * GLOBALS       -
 *
-* RETURNS       Error code (0 == Success)
+* RETURNS       Job number, -1 when no jobs are left
 *
-* HISTORY       2023 01 01   JPT   First implementation
+* HISTORY       2026 10 18   JPT   First implementation
 *
-* NOTES         -
+* NOTES         Work stealing: every thread owns a deque of jobs and takes
+*               them from the front, in the printing order. An idle thread
+*               steals from the back of the other deques, the jobs to be
+*               printed last. No jobs are added after the start, so empty
+*               deques everywhere mean the batch is done.
 *
 \**************************************************************************/
 
-int dijkstra(pentti_t *pentti, char *maze, mazeparam_t *mazeparam)
+int batch_next(batch_t *batch, int thread)
 {
-  int idx = 0;
-  int row = 0;
-  int col = 0;
-  int found = 0;
-  int mazesize = mazeparam -> rows * mazeparam -> cols;
-  int *exclusion = (int *) malloc(mazesize * sizeof(int));
-  parent_data_t *parent_data = (parent_data_t *) malloc(mazesize * sizeof(parent_data_t));
-  memset(exclusion, 0, mazesize * sizeof(int));
-  memset(parent_data, (unsigned char) 0xff, mazesize * sizeof (parent_data_t)); /* -1 */
-  set_parent_data(parent_data, mazeparam,
-                  mazeparam -> startrow, mazeparam -> startcol,
-                  mazeparam -> startrow, mazeparam -> startcol);
-  insert_unique(&(mazeparam -> olist), LIN(mazeparam -> startrow, mazeparam -> startcol));
-  set_pentti_at(pentti, maze, mazeparam, row, col);
-  pentti -> steps = 0;
-  while (mazeparam -> olist) {
-    idx = first_unique(mazeparam -> olist);
-    delete_first_unique(&(mazeparam -> olist));
-    ROWCOL (idx, row, col);
-    exclude (mazeparam, exclusion, row, col);
-    set_pentti_at(pentti, maze, mazeparam, row, col);
-    maze [pentti -> idx] = '.';
-    if (pentti -> steps < 200) maze [pentti -> idx] = 'c';
-    if (pentti -> steps < 150) maze [pentti -> idx] = 'b';
-    if (pentti -> steps <  20) maze [pentti -> idx] = 'a';
-    if ((pentti -> steps == 20) || (pentti -> steps == 150) || (pentti -> steps == 200)) {
-      printf("Intermediate state at %dth step\n\n", pentti -> steps);
-      printmaze(maze, mazeparam, 0);
-      printf("\n\n\n");
-    }
-    if (goalfound(pentti)) {
-      int tgtrow, tgtcol, tracerow, tracecol;
-      found = 1;
-      if (pentti -> northval == 'E') {
-        tgtrow = pentti -> northrow; tgtcol = pentti -> northcol;
-      }
-      if (pentti -> southval == 'E') {
-        tgtrow = pentti -> southrow; tgtcol = pentti -> southcol;
-      }
-      if (pentti -> eastval == 'E') {
-        tgtrow = pentti -> eastrow;  tgtcol = pentti -> eastcol;
-      }
-      if (pentti -> westval == 'E') {
-        tgtrow = pentti -> westrow;  tgtcol = pentti -> westcol;
-      }
-      set_parent_data(parent_data, mazeparam,
-                      tgtrow, tgtcol, pentti -> row, pentti -> col);
-      tracerow = pentti -> row; tracecol = pentti -> col;
-      while (1) {
-        int idx, prow, pcol;
-	get_parent_data(parent_data, mazeparam, tracerow, tracecol, &prow, &pcol);
-        if ((tracerow == prow) && (tracecol == pcol)) break;
-        idx = LIN(tracerow, tracecol);
-        if      (maze [idx] == 'a') maze [idx] = 'A';
-        else if (maze [idx] == 'b') maze [idx] = 'B';
-        else if (maze [idx] == 'c') maze [idx] = 'C';
-        else maze [idx] = 'O';
-        tracerow = prow;
-        tracecol = pcol;
-      }
-      break;
-    }
-    checkside(mazeparam, maze, exclusion, parent_data,
-              pentti -> atval, pentti -> northrow, pentti -> northcol,
-              pentti -> row, pentti -> col);
-    checkside(mazeparam, maze, exclusion, parent_data,
-              pentti -> atval,pentti -> eastrow, pentti -> eastcol,
-              pentti -> row, pentti -> col);
-    checkside(mazeparam, maze, exclusion, parent_data,
-              pentti -> atval, pentti -> southrow, pentti -> southcol,
-              pentti -> row, pentti -> col);
-    checkside(mazeparam, maze, exclusion, parent_data,
-              pentti -> atval, pentti -> westrow, pentti -> westcol,
-              pentti -> row, pentti -> col);
-  }  
-  prune_uniques(mazeparam -> olist);
-  mazeparam -> olist = NULL;
-  free(parent_data);
-  free(exclusion);
-  if (found == 0) {
-    printf("Exit not found after %d steps\n\n", pentti -> steps);
-    return (1);
+  for (int k = 0; k < batch -> threads; k++) {
+    deque_t *d = &(batch -> deque [(thread + k) % batch -> threads]);
+    int     job = -1;
+    pthread_mutex_lock(&(d -> lock));
+    if (d -> head < d -> tail) job = (k == 0) ? d -> head ++ : -- d -> tail;
+    pthread_mutex_unlock(&(d -> lock));
+    if (job != -1) return (job);
   }
-  printf("Final state at %dth step\n\n", pentti -> steps);
-  printmaze(maze, mazeparam, 0);
-  printf("\n\n\n");
-  return (0);
+  return (-1);
 }
 
 
 
 /**************************************************************************\
 *
-* FUNCTION      pledge
+* FUNCTION      copy_spill
 *
-* DESCRIPTION   Pledge's maze traversing algorithm
+* DESCRIPTION   Writes the spilled results of a job to the batch output
 *
-* ARGUMENTS     pentti      The current position and state
-*               maze        The maze map [INPUT]
-*               mazeparam   The maze parameter struct
+* ARGUMENTS     spill   The scratch file of the job, closed here
+*               out     The batch output
 *
 * GLOBALS       -
 *
-* RETURNS       Error code (0 == Success)
-*
-* HISTORY       2023 01 01   JPT   First implementation
+* RETURNS       -
 *
-* NOTES         This algorithm can be used as the classic wall-follower by
-*               setting pledge_enable = 0.
+* HISTORY       2026 10 18   JPT   First implementation
 *
-*               Heading is expressed as quarter-revolutions to the positive
-*               direction from east. This number may be reduced to its
-*               two lowest bits in order to confine it within [0 .. 3] where
-*               necessary.
+* NOTES         -
 *
 \**************************************************************************/
 
-int pledge(pentti_t *pentti, char *maze, mazeparam_t *mazeparam)
+void copy_spill(FILE *spill, FILE *out)
 {
-  int pledge_mode = 1;
-  if (   (mazeparam -> pledge_enable == 0)
-      && (mazeparam -> startcategory == START_INSIDE)) {
-    printf("Classic wall follower may not have a solution for\n"
-           "an internal starting point if the maze is not\n"
-           "simply connected. Try with pledge_enable = 1.\n\n");
-    return (2);
-  }
-  pentti -> unfolded_heading = 0;   /* East is the preferred heading */
-  set_pentti_at(pentti, maze, mazeparam,
-                mazeparam -> startrow, mazeparam -> startcol);
-  while (1) {
-    if (goalfound(pentti)) break;
-    pledge_mode = (int) (   (mazeparam -> pledge_enable != 0)
-                         && (pentti -> unfolded_heading == 0));
-    if (pentti -> sideval != '#') {
-      if (pledge_mode == 0) turn_pentti(pentti, maze, mazeparam, -1);
-      set_pentti_at(pentti, maze, mazeparam,
-                    pentti -> aheadrow, pentti -> aheadcol);
-    }
-    else if (pentti -> aheadval == '#')
-      turn_pentti(pentti, maze, mazeparam, 1);
-    else {
-      set_pentti_at(pentti, maze, mazeparam,
-                    pentti -> aheadrow, pentti -> aheadcol);
-    }
-    maze [pentti -> idx] = 'O';
-    if (pentti -> steps < 200) maze [pentti -> idx] = 'C';
-    if (pentti -> steps < 150) maze [pentti -> idx] = 'B';
-    if (pentti -> steps <  20) maze [pentti -> idx] = 'A';
-    if (   (pentti -> steps == 20)
-        || (pentti -> steps == 150)
-        || (pentti -> steps == 200)) {
-      printf("Intermediate state at %dth step\n\n", pentti -> steps);
-      printmaze(maze, mazeparam, 0);
-      printf("\n\n\n");
-    }
-  }
-  printf("Final state at %dth step\n\n", pentti -> steps);
-  return (0);
+  char   buf [65536];
+  size_t n;
+  rewind(spill);
+  while ((n = fread(buf, 1, sizeof (buf), spill)) > 0) fwrite(buf, 1, n, out);
+  fclose(spill);
 }
 
 
 
 /**************************************************************************\
 *
-* FUNCTION      mazeinit
+* FUNCTION      batch_worker
 *
-* DESCRIPTION   Maze allocation, initialization and sanity check
+* DESCRIPTION   Runs batch jobs until none are left
 *
-* ARGUMENTS     filename    Maze file name
-*               maze        The maze map
-*               mazeparam   The maze parameter struct
+* ARGUMENTS     arg   Pointer to the batch_work_t of the thread
 *
 * GLOBALS       -
 *
-* RETURNS       Error code (0 == Success)
+* RETURNS       NULL
 *
-* HISTORY       2023 01 01   JPT   First implementation
+* HISTORY       2026 10 18   JPT   First implementation
+*               2026 10 18   JPT   Head job streamed, others spilled
 *
-* NOTES         IMPORTANT: Allocates memory via loadmaze(). Freeing
-*               allocated memory is necessary if loadmaze() returns 0
-*               meaning successful completion.
+* NOTES         The first job not yet printed writes straight to the batch
+*               output, so a single thread streams every job. A job
+*               started ahead of it prints into a scratch file instead.
+*               When a job is done, every finished job not yet printed is
+*               copied to the batch output in job order, so the output is
+*               the same as that of a sequential run. The jobs run ahead
+*               thus keep their results on disk, not in memory.
 *
 \**************************************************************************/
 
-int mazeinit (char *filename, char **maze, mazeparam_t *mazeparam) {
-  int errcode;
-  mazeparam -> olist = NULL;
-  errcode = measuremaze(filename, mazeparam);
-  if (errcode) return (1);
-  errcode = loadmaze(filename, maze, mazeparam);
-  if (errcode) return (1);
-  errcode = endpoints(*maze, mazeparam);
-  if (errcode) {free(*maze); *maze = NULL; return (1);}
-  errcode = wall_sanity(*maze, mazeparam, 1);
-  if (errcode) {free(*maze); *maze = NULL; return (1);}
-  return (0);
+void *batch_worker(void *arg)
+{
+  batch_work_t *work = (batch_work_t *) arg;
+  batch_t      *batch = work -> batch;
+  int          j;
+  while ((j = batch_next(batch, work -> thread)) != -1) {
+    job_t *job = &(batch -> job [j]);
+    FILE  *f = batch -> out;
+    pthread_mutex_lock(&(batch -> outlock));
+    if (j != batch -> printed) f = job -> spill = tmpfile();
+    pthread_mutex_unlock(&(batch -> outlock));
+    if (f == NULL) {
+      fprintf(stderr, "Cannot create a scratch file for job output.\n");
+      job -> rv = 1;
+    }
+    else job -> rv = runalgorithm(job -> algorithm, job -> filename, job -> cache, f);
+    release_mazecache(job -> cache);
+    pthread_mutex_lock(&(batch -> outlock));
+    job -> done = 1;
+    while ((batch -> printed < batch -> jobs) && batch -> job [batch -> printed].done) {
+      job_t *p = &(batch -> job [batch -> printed ++]);
+      if (p -> spill) copy_spill(p -> spill, batch -> out);
+      p -> spill = NULL;
+      if (p -> rv) batch -> rv = 1;
+    }
+    pthread_mutex_unlock(&(batch -> outlock));
+  }
+  return (NULL);
 }
 
 
 
 /**************************************************************************\
 *
-* FUNCTION      solvemaze
+* FUNCTION      run_batch
 *
-* DESCRIPTION   Top level caller to invoke a single solving algorithm
+* DESCRIPTION   Solves a list of maze files with a list of algorithms
 *
-* ARGUMENTS     solver     The chosen algorithm (a function pointer)
-*               filename   The name of the maze fiole to solve
-*               flags      Special requests (e.g. Pledge mode)
+* ARGUMENTS     list        The maze files
+*               chosen      The algorithms
+*               nchosen     Number of algorithms
+*               threads     Number of threads
+*               rle         Flag to keep the mazes as run-length rows
+*               budget      Limits of the wall walkers, zeros for none
+*               out         Destination of the printed results
 *
 * GLOBALS       -
 *
-* RETURNS       Error code (0 == Success)
+* RETURNS       Error code (0 == Success, 1 if any job failed)
 *
-* HISTORY       2023 01 01   JPT   First implementation
+* HISTORY       2026 10 18   JPT   First implementation
+*               2026 10 18   JPT   Run-length rows
+*               2026 10 18   JPT   Walker budget
+*               2026 10 18   JPT   Threads of a job
+*               2026 10 18   JPT   Failure flag instead of a sum
+*
+* NOTES         A job is one algorithm on one file, numbered file by file.
+*               The jobs are dealt to the threads in contiguous blocks, so
+*               the jobs of a file tend to run on one thread and share its
+*               graph cache. The calling thread works as the thread 0.
 *
-* NOTES         IMPORTANT: Remember to free the memory allocated by
-*               loadmaze() via mazeinit(). A failed mazeinit (nonzero
-*               return)has released the memory for you already.
+*               When more than one thread runs jobs, the online processors
+*               are shared between them, and a job may start threads of
+*               its own only up to its share. A single thread leaves the
+*               jobs to one thread per processor.
 *
 \**************************************************************************/
 
-int solvemaze(solver_t solver, char *filename, int flags) {
-  mazeparam_t mazeparam;
-  char        *maze = NULL;
-  pentti_t    pentti;
-  int rv = 0;
-  rv = mazeinit(filename, &maze, &mazeparam);
-  if (rv != 0) return (rv);
-  mazeparam.pledge_enable = (int) ((flags & PLEDGE_ENABLE) != 0);
-  pentti.row   = mazeparam.startrow;
-  pentti.col   = mazeparam.startcol;
-  pentti.steps = 0;
-  printf("Maze %s, size %d x %d.\n\n"
-         "Legend: A = up to 20 steps, B = up to 150 steps,\n"
-         "C = up to 200 steps, O = more than 200 steps\n\n",
-         filename, mazeparam.cols, mazeparam.rows);
-  rv = solver(&pentti, maze, &mazeparam);
-  if (rv == 2) {
-    free(maze);
-    maze = NULL;
-    return (rv);
+int run_batch(filelist_t *list, algorithm_t **chosen, int nchosen, int threads,
+              int rle, budget_t budget, FILE *out)
+{
+  batch_t      batch;
+  mazecache_t  *cache;
+  batch_work_t *work;
+  pthread_t    *tid;
+  int          started = 1;
+  int          share = 0;
+  memset(&batch, 0, sizeof (batch_t));
+  if (threads < 1) threads = 1;
+  batch.jobs = list -> files * nchosen;
+  batch.out = out;
+  batch.job = (job_t *) calloc(batch.jobs + 1, sizeof (job_t));
+  batch.deque = (deque_t *) calloc(threads, sizeof (deque_t));
+  cache = (mazecache_t *) calloc(list -> files + 1, sizeof (mazecache_t));
+  work = (batch_work_t *) calloc(threads, sizeof (batch_work_t));
+  tid = (pthread_t *) calloc(threads, sizeof (pthread_t));
+  if (   (batch.job == NULL) || (batch.deque == NULL) || (cache == NULL)
+      || (work == NULL) || (tid == NULL)) {
+    fprintf(stderr, "Cannot allocate memory for batch jobs.\n");
+    free(batch.job);
+    free(batch.deque);
+    free(cache);
+    free(work);
+    free(tid);
+    return (1);
   }
-  int mazesize = mazeparam.rows * mazeparam.cols;
-  int pl = 0;
-  for (int i = 0; i < mazesize; i++) {
-    if (strchr("ABCO", maze [i])) pl++;
+  pthread_mutex_init(&batch.outlock, NULL);
+  if ((threads > 1) && (batch.jobs > 1)) {
+    int busy = (threads < batch.jobs) ? threads : batch.jobs;
+    share = cpu_count() / busy;
+    if (share < 1) share = 1;
   }
-  printf("Solution, path has %d steps\n\n", pl);
-  printmaze(maze, &mazeparam, 1);
-  printf("\n\n\n");
-  free(maze);
-  maze = NULL;
-  return (0);
+  for (int f = 0; f < list -> files; f++) {
+    init_mazecache(&cache [f], nchosen);
+    cache [f].rle = rle;
+    cache [f].budget = budget;
+    cache [f].threads = share;
+    for (int a = 0; a < nchosen; a++) {
+      batch.job [f * nchosen + a].algorithm = chosen [a];
+      batch.job [f * nchosen + a].filename = list -> name [f];
+      batch.job [f * nchosen + a].cache = &cache [f];
+    }
+  }
+  batch.threads = threads;
+  for (int t = 0; t < threads; t++) {
+    pthread_mutex_init(&batch.deque [t].lock, NULL);
+    batch.deque [t].head = (int) ((long long) batch.jobs * t / threads);
+    batch.deque [t].tail = (int) ((long long) batch.jobs * (t + 1) / threads);
+    work [t].batch = &batch;
+    work [t].thread = t;
+  }
+  for (; started < threads; started++) {
+    if (pthread_create(&tid [started], NULL, batch_worker, &work [started])) break;
+  }
+  batch_worker(&work [0]);   /* Steals the jobs of threads not started */
+  for (int t = 1; t < started; t++) pthread_join(tid [t], NULL);
+  for (int t = 0; t < threads; t++) pthread_mutex_destroy(&batch.deque [t].lock);
+  pthread_mutex_destroy(&batch.outlock);
+  free(batch.job);
+  free(batch.deque);
+  free(cache);
+  free(work);
+  free(tid);
+  return (batch.rv);
 }
@@ -42,9 +42,9 @@
 void test_goalfound(pentti_t *pentti, char *maze, mazeparam_t *mazeparam)
 {
   set_pentti_at(pentti, maze, mazeparam, 1, 7);
-  assert(goalfound (pentti) == 1);
+  assert(goalfound (pentti, maze, mazeparam) == 1);
   set_pentti_at(pentti, maze, mazeparam, 1, 8);
-  assert(goalfound (pentti) == 0);
+  assert(goalfound (pentti, maze, mazeparam) == 0);
 }
 
 
@@ -121,6 +121,7 @@ void test_mazeval(char *maze, mazeparam_t *mazeparam)
 * RETURNS       -
 *
 * HISTORY       2023 01 01   JPT   First implementation
+*               2026 10 18   JPT   Offsets and step_pentti()
 *
 * NOTES         -
 *
@@ -130,19 +131,21 @@ void test_set_pentti_at(pentti_t *pentti, char *maze, mazeparam_t *mazeparam)
 {
   pentti -> steps = 0;
   set_pentti_at (pentti, maze, mazeparam, 10, 20);
-  assert(pentti -> northrow ==    9);
-  assert(pentti -> northcol ==   20);
-  assert(pentti -> northidx ==  9 * mazeparam -> cols + 20);
-  assert(pentti -> eastrow  ==   10);
-  assert(pentti -> eastcol  ==   21);
-  assert(pentti -> eastidx  == 10 * mazeparam -> cols + 21);
-  assert(pentti -> southrow ==   11);
-  assert(pentti -> southcol ==   20);
-  assert(pentti -> southidx == 11 * mazeparam -> cols + 20);
-  assert(pentti -> westrow  ==   10);
-  assert(pentti -> westcol  ==   19);
-  assert(pentti -> westidx  == 10 * mazeparam -> cols + 19);
+  assert(pentti -> row      ==   10);
+  assert(pentti -> col      ==   20);
+  assert(pentti -> idx      == 10 * mazeparam -> cols + 20);
+  assert(pentti -> idx + pentti -> offset [1] ==  9 * mazeparam -> cols + 20);
+  assert(pentti -> idx + pentti -> offset [0] == 10 * mazeparam -> cols + 21);
+  assert(pentti -> idx + pentti -> offset [3] == 11 * mazeparam -> cols + 20);
+  assert(pentti -> idx + pentti -> offset [2] == 10 * mazeparam -> cols + 19);
   assert(pentti -> steps    ==    1);
+  pentti -> unfolded_heading = 1;
+  set_pentti_at (pentti, maze, mazeparam, 10, 20);
+  step_pentti (pentti);
+  assert(pentti -> row      ==    9);
+  assert(pentti -> col      ==   20);
+  assert(pentti -> idx      ==  9 * mazeparam -> cols + 20);
+  assert(pentti -> steps    ==    3);
 }
 
 
@@ -162,6 +165,7 @@ void test_set_pentti_at(pentti_t *pentti, char *maze, mazeparam_t *mazeparam)
 * RETURNS       -
 *
 * HISTORY       2023 01 01   JPT   First implementation
+*               2026 10 18   JPT   Neighbours by pentti_look()
 *
 * NOTES         A turn does not count as a step.
 *
@@ -172,16 +176,16 @@ void test_turn_pentti(pentti_t *pentti, char *maze, mazeparam_t *mazeparam)
   pentti -> unfolded_heading = 4;
   set_pentti_at (pentti, maze, mazeparam, 1, 1);
   assert(pentti -> folded_heading == 0);
-  assert(pentti -> southval == ' ');
-  assert(pentti -> eastval  == '#');
-  assert(pentti -> aheadval == '#');
-  assert(pentti -> sideval  == ' ');
-  turn_pentti (pentti, maze, mazeparam, 1);
+  assert(pentti_look(pentti, maze, mazeparam, 3) == ' ');   /* South */
+  assert(pentti_look(pentti, maze, mazeparam, 0) == '#');   /* East */
+  assert(pentti_look(pentti, maze, mazeparam, pentti -> folded_heading) == '#');
+  assert(pentti_look(pentti, maze, mazeparam, pentti -> folded_heading + 3) == ' ');
+  turn_pentti (pentti, 1);
   assert(pentti -> folded_heading == 1);
-  assert(pentti -> southval == ' ');
-  assert(pentti -> eastval  == '#');
-  assert(pentti -> aheadval == '#');
-  assert(pentti -> sideval  == '#');
+  assert(pentti_look(pentti, maze, mazeparam, 3) == ' ');
+  assert(pentti_look(pentti, maze, mazeparam, 0) == '#');
+  assert(pentti_look(pentti, maze, mazeparam, pentti -> folded_heading) == '#');
+  assert(pentti_look(pentti, maze, mazeparam, pentti -> folded_heading + 3) == '#');
 }
 
 
@@ -205,12 +209,15 @@ void test_turn_pentti(pentti_t *pentti, char *maze, mazeparam_t *mazeparam)
 *
 \**************************************************************************/
 
-void test_exclude(mazeparam_t *mazeparam, int *exclusion)
+void test_exclude(mazeparam_t *mazeparam, bitword_t *exclusion)
 {
   assert(exclusion_at(mazeparam, exclusion, 1, 1) == 0);
   exclude(mazeparam, exclusion, 1, 1);
   assert(exclusion_at(mazeparam, exclusion, 1, 1) == 1);
   assert(exclusion_at(mazeparam, exclusion, 2, 1) == 0);
+  assert(exclusion_at(mazeparam, exclusion, 1, 2) == 0);
+  assert(exclusion_at(mazeparam, exclusion, -1, 1) == 1);
+  assert(exclusion [LIN(1, 1) >> 6] == 1ULL << (LIN(1, 1) & 63));
 }
 
 
@@ -221,7 +228,7 @@ void test_exclude(mazeparam_t *mazeparam, int *exclusion)
 *
 * DESCRIPTION   Test for parental data setting and retrieval
 *
-* ARGUMENTS     parent_data  Parallel map layer for coordinate pairs
+* ARGUMENTS     parent_data  Parallel map layer for parent headings
 *               mazeparam    The maze parameter struct
 *
 * GLOBALS       -
@@ -229,6 +236,7 @@ void test_exclude(mazeparam_t *mazeparam, int *exclusion)
 * RETURNS       -
 *
 * HISTORY       2023 01 01   JPT   First implementation
+*               2026 10 18   JPT   Neighbour parents only
 *
 * NOTES         Tests also get_parent_data.
 *
@@ -240,10 +248,21 @@ void test_set_parent_data(parent_data_t *parent_data, mazeparam_t *mazeparam)
   get_parent_data(parent_data, mazeparam, 1, 1, &row, &col);
   assert(row == -1);
   assert(col == -1);
-  set_parent_data(parent_data, mazeparam, 1, 1, 30, 40);
+  set_parent_data(parent_data, mazeparam, 1, 1, 2, 1);
+  get_parent_data(parent_data, mazeparam, 1, 1, &row, &col);
+  assert(row == 2);
+  assert(col == 1);
+  set_parent_data(parent_data, mazeparam, 1, 2, 1, 1);   /* Same byte */
+  set_parent_data(parent_data, mazeparam, 1, 3, 0, 3);
+  get_parent_data(parent_data, mazeparam, 1, 2, &row, &col);
+  assert((row == 1) && (col == 1));
+  get_parent_data(parent_data, mazeparam, 1, 3, &row, &col);
+  assert((row == 0) && (col == 3));
   get_parent_data(parent_data, mazeparam, 1, 1, &row, &col);
-  assert(row == 30);
-  assert(col == 40);
+  assert((row == 2) && (col == 1));
+  set_parent_data(parent_data, mazeparam, 2, 1, 2, 1);   /* Root */
+  get_parent_data(parent_data, mazeparam, 2, 1, &row, &col);
+  assert((row == 2) && (col == 1));
 }
 
 
@@ -272,21 +291,1505 @@ void test_dijkstra(char *maze, mazeparam_t *mazeparam)
 {
   int mazesize = mazeparam -> rows * mazeparam -> cols;
   assert(mazesize == 19 * 37);
-  int *exclusion = (int *) malloc (mazesize * sizeof(int));
-  parent_data_t *parent_data =
-    (parent_data_t *) malloc (mazesize * sizeof(parent_data_t));
-  memset(exclusion, 0, mazesize * sizeof(int));
-  memset(parent_data,
-         (unsigned char) 0xff,
-         mazesize * sizeof(parent_data_t));   /* Produces int -1's */
+  bitword_t *exclusion =
+    (bitword_t *) malloc (BITWORDS(mazesize) * sizeof(bitword_t));
+  parent_data_t parent_data;
+  memset(exclusion, 0, BITWORDS(mazesize) * sizeof(bitword_t));
+  assert(init_parent_data(&parent_data, mazesize) == 0);
   test_exclude(mazeparam, exclusion);
-  test_set_parent_data(parent_data, mazeparam);
-  free(parent_data);
+  test_set_parent_data(&parent_data, mazeparam);
+  free_parent_data(&parent_data);
   free(exclusion);
 }
 
 
 
+/************************************************************************** \
+*
+* FUNCTION      test_uniques
+*
+* DESCRIPTION   Ordered set test common to the list and bitmap backends
+*
+* ARGUMENTS     -
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The values span several bitmap words and levels.
+*
+\**************************************************************************/
+
+void test_uniques()
+{
+  olist_t *olist = NULL;
+  int vals [] = {4095, 64, 63, 300000, 0, 4096, 64};
+  for (int i = 0; i < 7; i++) insert_unique(&olist, vals [i]);
+  assert(first_unique(olist) == 0);
+  assert(last_unique(olist) == 300000);
+  delete_first_unique(&olist);
+  assert(first_unique(olist) == 63);
+  delete_last_unique(&olist);
+  assert(last_unique(olist) == 4096);
+  delete_unique(&olist, 63);
+  delete_unique(&olist, 4096);
+  delete_unique(&olist, 12345);
+  assert(first_unique(olist) == 64);
+  assert(last_unique(olist) == 4095);
+  delete_first_unique(&olist);
+  assert(first_unique(olist) == 4095);
+  delete_last_unique(&olist);
+  assert(olist == NULL);
+  insert_unique(&olist, 7);
+  prune_uniques(olist);
+}
+
+
+
+/************************************************************************** \
+*
+* FUNCTION      test_pool
+*
+* DESCRIPTION   Pooled ordered set test
+*
+* ARGUMENTS     -
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         Spans several slabs and checks node recycling.
+*
+\**************************************************************************/
+
+void test_pool()
+{
+  opool_t pool;
+  olist_t *olist = NULL;
+  olist_t *recycled = NULL;
+  int n = 3 * POOL_SLAB_NODES;
+  init_pool(&pool);
+  for (int i = n - 1; i >= 0; i--) insert_unique_pooled(&olist, i, &pool);
+  insert_unique_pooled(&olist, 5, &pool);
+#ifndef UNIQUES_BITMAP
+  assert(pool.slabs == 3);
+#endif
+  assert(first_unique(olist) == 0);
+  assert(last_unique(olist) == n - 1);
+  delete_last_unique_pooled(&olist, &pool);
+  assert(last_unique(olist) == n - 2);
+  delete_unique_pooled(&olist, 0, &pool);
+  assert(first_unique(olist) == 1);
+#ifndef UNIQUES_BITMAP   /* Node recycling applies to the list backend */
+  recycled = pool.freelist;
+  insert_unique_pooled(&olist, 0, &pool);
+  assert(olist == recycled);
+  delete_first_unique_pooled(&olist, &pool);
+  delete_first_unique_pooled(&olist, &pool);
+  assert(first_unique(olist) == 2);
+  reset_pool(&pool);
+  olist = NULL;
+  insert_unique_pooled(&olist, 7, &pool);
+  assert(olist == &(pool.slab [0] [0]));
+  assert(pool.slabs == 3);
+#else
+  prune_uniques_pooled(olist, &pool);
+#endif
+  free_pool(&pool);
+  olist = NULL;
+  for (int i = 0; i < 1000; i++) insert_unique(&olist, i);
+  delete_last_unique(&olist);
+  assert(last_unique(olist) == 998);
+  prune_uniques(olist);
+}
+
+
+
+/************************************************************************** \
+*
+* FUNCTION      test_heap
+*
+* DESCRIPTION   Keyed heap ordering and decrease-key test
+*
+* ARGUMENTS     -
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         Equal keys must come out in ascending value order.
+*
+\**************************************************************************/
+
+void test_heap()
+{
+  oheap_t heap;
+  long long key;
+  assert(init_heap(&heap, 100) == 0);
+  insert_heap(&heap, 50, 3);
+  insert_heap(&heap, 10, 3);
+  insert_heap(&heap, 70, 1);
+  insert_heap(&heap, 20, 5);
+  assert(heap.size == 4);
+  assert(key_heap(&heap, 20) == 5);
+  assert(key_heap(&heap, 30) == LLONG_MAX);
+  insert_heap(&heap, 20, 0);               /* Acts as decrease-key */
+  insert_heap(&heap, 70, 9);               /* Larger key is ignored */
+  assert(heap.size == 4);
+  assert(first_heap(&heap, &key) == 20);
+  assert(key == 0);
+  delete_first_heap(&heap);
+  assert(first_heap(&heap, &key) == 70);
+  delete_first_heap(&heap);
+  assert(first_heap(&heap, &key) == 10);
+  assert(key == 3);
+  delete_first_heap(&heap);
+  assert(first_heap(&heap, NULL) == 50);
+  delete_first_heap(&heap);
+  assert(heap.size == 0);
+  assert(key_heap(&heap, 50) == LLONG_MAX);
+  free_heap(&heap);
+}
+
+
+
+/************************************************************************** \
+*
+* FUNCTION      test_bucket
+*
+* DESCRIPTION   Bucket queue ordering and decrease-key test
+*
+* ARGUMENTS     -
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         Equal keys must come out in insertion order.
+*
+\**************************************************************************/
+
+void test_bucket()
+{
+  obucket_t queue;
+  int key;
+  assert(init_bucket(&queue, 100, 1) == 0);
+  insert_bucket(&queue, 50, 0);
+  assert(first_bucket(&queue, &key) == 50);
+  assert(key == 0);
+  delete_first_bucket(&queue);
+  insert_bucket(&queue, 40, 1);
+  insert_bucket(&queue, 30, 1);
+  insert_bucket(&queue, 20, 1);
+  assert(first_bucket(&queue, &key) == 40);
+  delete_first_bucket(&queue);
+  insert_bucket(&queue, 10, 2);
+  insert_bucket(&queue, 60, 2);
+  insert_bucket(&queue, 60, 1);            /* Acts as decrease-key */
+  assert(queue.size == 4);
+  assert(key_bucket(&queue, 60) == 1);
+  assert(key_bucket(&queue, 40) == INT_MAX);
+  assert(first_bucket(&queue, NULL) == 30);
+  delete_first_bucket(&queue);
+  assert(first_bucket(&queue, NULL) == 20);
+  delete_first_bucket(&queue);
+  assert(first_bucket(&queue, &key) == 60);
+  assert(key == 1);
+  delete_first_bucket(&queue);
+  assert(first_bucket(&queue, &key) == 10);
+  assert(key == 2);
+  delete_first_bucket(&queue);
+  assert(queue.size == 0);
+  free_bucket(&queue);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      test_mapmaze
+*
+* DESCRIPTION   Single pass loader test
+*
+* ARGUMENTS     filename    Maze file name
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The loader must agree with measuremaze(), loadmaze() and
+*               endpoints(). The scratch file has rows longer than the
+*               vector width, CRLF line ends and text after the blank line
+*               ending the maze.
+*
+\**************************************************************************/
+
+void test_mapmaze(char *filename)
+{
+  mazeparam_t mapped, loaded;
+  char        *mapmz = NULL, *loadmz = NULL;
+  char        *scratch = "test_mapmaze.tmp";
+  FILE        *f;
+  assert(mapmaze(filename, &mapmz, NULL, &mapped) == 0);
+  loaded.overlay = NULL;
+  loaded.rle = NULL;
+  assert(measuremaze(filename, &loaded) == 0);
+  assert(loadmaze(filename, &loadmz, &loaded) == 0);
+  assert(endpoints(loadmz, &loaded) == 0);
+  assert(mapped.rows == loaded.rows);
+  assert(mapped.cols == loaded.cols);
+  assert(memcmp(mapmz, loadmz, loaded.rows * loaded.cols) == 0);
+  assert(mapped.startrow == loaded.startrow);
+  assert(mapped.startcol == loaded.startcol);
+  assert(mapped.startcategory == loaded.startcategory);
+  assert(mapped.exits == loaded.exits);
+  assert(mapped.exitrow [0] == loaded.exitrow [0]);
+  assert(mapped.exitcol [0] == loaded.exitcol [0]);
+  free(mapmz);
+  free(loadmz);
+  f = fopen(scratch, "w");
+  fprintf(f, "#######################################E#\r\n"
+             "#                 ^                     #\r\n"
+             "E########################################\r\n"
+             "\r\n"
+             "E\n");
+  fclose(f);
+  assert(mapmaze(scratch, &mapmz, NULL, &mapped) == 0);
+  assert(mapped.rows == 3);
+  assert(mapped.cols == 41);
+  assert(mapped.startrow == 1);
+  assert(mapped.startcol == 18);
+  assert(mapped.startcategory == START_INSIDE);
+  assert(mapped.exits == 2);
+  assert(mapped.exitcol [0] == 39);
+  assert(mapped.exitrow [1] == 2);
+  assert(mapmz [2 * 41 + 40] == '#');
+  free(mapmz);
+  f = fopen(scratch, "w");
+  fprintf(f, "#####\n#^  #\n####\n");
+  fclose(f);
+  assert(mapmaze(scratch, &mapmz, NULL, &mapped) == 1);
+  f = fopen(scratch, "w");
+  fprintf(f, "#EEE#\n#^  #\n#EE##\n");
+  fclose(f);
+  assert(mapmaze(scratch, &mapmz, NULL, &mapped) == 1);
+  remove(scratch);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      test_wide_maze
+*
+* DESCRIPTION   Test of a maze wider than the old 1021 column limit
+*
+* ARGUMENTS     -
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         A corridor of 60000 columns between the start in the west
+*               and the exit in the east. Both loaders must accept it, and
+*               the printed rows must have full width.
+*
+\**************************************************************************/
+
+void test_wide_maze(void)
+{
+  int         cols = 60000;
+  char        *scratch = "test_wide_maze.tmp";
+  char        *row = (char *) malloc(cols + 1);
+  char        *maze = NULL, *loaded = NULL, *text = NULL;
+  size_t      textsize = 0;
+  mazeparam_t mazeparam;
+  pentti_t    pentti;
+  FILE        *f = fopen(scratch, "w");
+  row [cols] = '\0';
+  memset(row, '#', cols);
+  fprintf(f, "%s\n", row);
+  memset(row, ' ', cols);
+  row [0] = '^';
+  row [cols - 1] = 'E';
+  fprintf(f, "%s\n", row);
+  memset(row, '#', cols);
+  fprintf(f, "%s\n", row);
+  fclose(f);
+  assert(measuremaze(scratch, &mazeparam) == 0);
+  assert(mazeparam.cols == cols);
+  assert(loadmaze(scratch, &loaded, &mazeparam) == 0);
+  assert(mazeinit(scratch, &maze, &mazeparam) == 0);
+  assert(mazeparam.rows == 3);
+  assert(mazeparam.cols == cols);
+  assert(memcmp(maze, loaded, 3 * cols) == 0);
+  assert(init_overlay(&mazeparam) == 0);
+  mazeparam.pledge_enable = 1;
+  mazeparam.out = open_memstream(&text, &textsize);
+  pentti.steps = 0;
+  assert(pledge(&pentti, maze, &mazeparam) == 0);
+  assert(pathlength(maze, &mazeparam) == cols - 2);
+  assert(printmaze(maze, &mazeparam, 1) == 0);
+  fclose(mazeparam.out);
+  assert(strstr(text, "^AAAA") != NULL);
+  assert(strstr(text, "OOOOE\n") != NULL);
+  assert(textsize > (size_t) 3 * (cols + 1));
+  free_overlay(&mazeparam);
+  free(text);
+  free(maze);
+  free(loaded);
+  free(row);
+  remove(scratch);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      test_packmaze
+*
+* DESCRIPTION   Binary maze format round trip test
+*
+* ARGUMENTS     filename    Maze file name
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The binary file must be the header and one bit per square,
+*               and mazeinit() must load it into the same maze as the
+*               text. A file of an unknown version is refused.
+*
+\**************************************************************************/
+
+void test_packmaze(char *filename)
+{
+  mazeparam_t text, binary;
+  char        *textmz = NULL, *binmz = NULL;
+  char        *scratch = "test_packmaze.tmp";
+  FILE        *f;
+  long        size;
+  assert(mazeinit(filename, &textmz, &text) == 0);
+  f = fopen(scratch, "wb");
+  assert(packmaze(textmz, &text, f) == 0);
+  size = ftell(f);
+  fclose(f);
+  assert(size == MAZEBIN_HEADER + (19 * 37 + 7) / 8);
+  assert(mazeinit(scratch, &binmz, &binary) == 0);
+  assert(binary.rows == text.rows);
+  assert(binary.cols == text.cols);
+  assert(memcmp(binmz, textmz, text.rows * text.cols) == 0);
+  assert(binary.startrow == text.startrow);
+  assert(binary.startcol == text.startcol);
+  assert(binary.startcategory == text.startcategory);
+  assert(binary.exits == text.exits);
+  assert(binary.exitrow [0] == text.exitrow [0]);
+  assert(binary.exitcol [0] == text.exitcol [0]);
+  free(binmz);
+  f = fopen(scratch, "r+b");
+  fseek(f, 4, SEEK_SET);
+  fputc(MAZEBIN_VERSION + 1, f);
+  fclose(f);
+  assert(mazeinit(scratch, &binmz, &binary) == 1);
+  free(textmz);
+  remove(scratch);
+}
+
+
+
+/************************************************************************** \
+*
+* FUNCTION      test_frontiers
+*
+* DESCRIPTION   Dijkstra's algorithm result test for each frontier type
+*
+* ARGUMENTS     filename    Maze file name
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The distance ordered frontiers must agree on the shortest
+*               path. The list frontier reproduces the original search.
+*
+\**************************************************************************/
+
+void test_frontiers(char *filename)
+{
+  int frontiers [3] = {FRONTIER_HEAP, FRONTIER_BUCKET, FRONTIER_LIST};
+  int lengths   [3] = {38, 38, 54};
+  for (int i = 0; i < 3; i++) {
+    mazeparam_t mazeparam;
+    char        *maze = NULL;
+    pentti_t    pentti;
+    assert(mazeinit(filename, &maze, &mazeparam) == 0);
+    assert(init_overlay(&mazeparam) == 0);
+    mazeparam.pledge_enable = 0;
+    mazeparam.frontier = frontiers [i];
+    pentti.steps = 0;
+    assert(dijkstra(&pentti, maze, &mazeparam) == 0);
+    assert(pathlength(maze, &mazeparam) == lengths [i]);
+    free_overlay(&mazeparam);
+    free(maze);
+  }
+}
+
+
+
+/************************************************************************** \
+*
+* FUNCTION      test_bitboard
+*
+* DESCRIPTION   Bitboard BFS row kernel and shortest path test
+*
+* ARGUMENTS     filename    Maze file name
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The row is 5 words long to exercise both the vector and
+*               the scalar tails of the kernel, and the carries between
+*               words.
+*
+\**************************************************************************/
+
+void test_bitboard(char *filename)
+{
+  bitword_t cur [7] = {0}, up [7] = {0}, down [7] = {0};
+  bitword_t open [7], visited [7] = {0}, next [7] = {0};
+  mazeparam_t mazeparam;
+  char        *maze = NULL;
+  pentti_t    pentti;
+  for (int w = 0; w < 7; w++) open [w] = ~0ULL;
+  cur [1] = 1ULL << 63;                       /* Column 63 */
+  cur [5] = 1ULL;                             /* Column 256 */
+  up [2] = 1ULL << 5;                         /* Column 69 above */
+  visited [1] = 1ULL << 62;
+  assert(bitboard_expand_row(cur + 1, up + 1, down + 1, open + 1,
+                             visited + 1, next + 1, 5) == 1);
+  assert(next [1] == 0);                      /* 62 visited, 63 not new */
+  assert(next [2] == ((1ULL << 0) | (1ULL << 5)));
+  assert(next [4] == 1ULL << 63);
+  assert(next [5] == 1ULL << 1);
+  assert(visited [2] == next [2]);
+  assert(bitboard_expand_row(down + 1, down + 1, down + 1, open + 1,
+                             visited + 1, next + 1, 5) == 0);
+  assert(mazeinit(filename, &maze, &mazeparam) == 0);
+  assert(init_overlay(&mazeparam) == 0);
+  pentti.steps = 0;
+  assert(bitboard(&pentti, maze, &mazeparam) == 0);
+  assert(pathlength(maze, &mazeparam) == 38);
+  assert(pentti.steps == 38);
+  free_overlay(&mazeparam);
+  free(maze);
+}
+
+
+
+/************************************************************************** \
+*
+* FUNCTION      test_bidirectional
+*
+* DESCRIPTION   Bidirectional search shortest path and effort test
+*
+* ARGUMENTS     filename    Maze file name
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         Dijkstra's algorithm expands 357 squares in this maze.
+*               A start next to an exit has a path of 0 steps, as with
+*               the other searches.
+*
+\**************************************************************************/
+
+void test_bidirectional(char *filename)
+{
+  char        *scratch = "test_bidirectional.tmp";
+  mazeparam_t mazeparam;
+  char        *maze = NULL;
+  pentti_t    pentti;
+  FILE        *f;
+  assert(mazeinit(filename, &maze, &mazeparam) == 0);
+  assert(init_overlay(&mazeparam) == 0);
+  pentti.steps = 0;
+  assert(bidirectional(&pentti, maze, &mazeparam) == 0);
+  assert(pathlength(maze, &mazeparam) == 38);
+  assert(pentti.steps < 357);
+  free_overlay(&mazeparam);
+  free(maze);
+  f = fopen(scratch, "w");
+  fprintf(f, "#####\n#  ^E\n#####\n");
+  fclose(f);
+  assert(mazeinit(scratch, &maze, &mazeparam) == 0);
+  mazeparam.out = fopen("/dev/null", "w");
+  assert(init_overlay(&mazeparam) == 0);
+  pentti.steps = 0;
+  assert(bidirectional(&pentti, maze, &mazeparam) == 0);
+  assert(pathlength(maze, &mazeparam) == 0);
+  free_overlay(&mazeparam);
+  fclose(mazeparam.out);
+  free(maze);
+  remove(scratch);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      test_astar
+*
+* DESCRIPTION   A* shortest path and effort test
+*
+* ARGUMENTS     filename    Maze file name
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         Both heuristics must keep the path length of Dijkstra's
+*               algorithm, and the exit heuristic must expand fewer than
+*               its 357 squares.
+*
+\**************************************************************************/
+
+void test_astar(char *filename)
+{
+  mazeparam_t mazeparam;
+  char        *maze = NULL;
+  pentti_t    pentti;
+  assert(heuristic(&(mazeparam_t) {.rows = 5, .cols = 5, .wall_heuristic = 1},
+                   2, 2) == 1);
+  assert(mazeinit(filename, &maze, &mazeparam) == 0);
+  assert(init_overlay(&mazeparam) == 0);
+  mazeparam.wall_heuristic = 0;
+  pentti.steps = 0;
+  assert(astar(&pentti, maze, &mazeparam) == 0);
+  assert(pathlength(maze, &mazeparam) == 38);
+  assert(pentti.steps < 357);
+  free_overlay(&mazeparam);
+  free(maze);
+  maze = NULL;
+  assert(mazeinit(filename, &maze, &mazeparam) == 0);
+  assert(init_overlay(&mazeparam) == 0);
+  mazeparam.wall_heuristic = 1;
+  pentti.steps = 0;
+  assert(astar(&pentti, maze, &mazeparam) == 0);
+  assert(pathlength(maze, &mazeparam) == 38);
+  free_overlay(&mazeparam);
+  free(maze);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      test_jps
+*
+* DESCRIPTION   Jump Point Search shortest path and effort test
+*
+* ARGUMENTS     filename    Maze file name
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The square (1, 35) lies next to the exit on the right edge
+*               of the test maze. Dijkstra's algorithm expands 357 squares.
+*
+\**************************************************************************/
+
+void test_jps(char *filename)
+{
+  mazeparam_t mazeparam;
+  char        *maze = NULL;
+  pentti_t    pentti;
+  assert(mazeinit(filename, &maze, &mazeparam) == 0);
+  assert(init_overlay(&mazeparam) == 0);
+  assert(walkable(maze, &mazeparam, -1, 0) == 0);
+  assert(nextto_exit(maze, &mazeparam, 1, 35) == 1);
+  assert(nextto_exit(maze, &mazeparam, 1, 34) == 0);
+  mazeparam.wall_heuristic = 0;
+  pentti.steps = 0;
+  assert(jps(&pentti, maze, &mazeparam) == 0);
+  assert(pathlength(maze, &mazeparam) == 38);
+  assert(pentti.steps < 357 / 4);
+  free_overlay(&mazeparam);
+  free(maze);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      test_junction
+*
+* DESCRIPTION   Junction graph construction, caching and search test
+*
+* ARGUMENTS     filename    Maze file name
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         Every edge is stored at both of its ends, so the edge
+*               count is even. The cache is shared by two runs, and the
+*               second release frees the graph.
+*
+\**************************************************************************/
+
+void test_junction(char *filename)
+{
+  mazeparam_t      mazeparam;
+  char             *maze = NULL;
+  pentti_t         pentti;
+  junction_graph_t *graph;
+  mazecache_t      cache;
+  int              start;
+  assert(mazeinit(filename, &maze, &mazeparam) == 0);
+  assert(init_overlay(&mazeparam) == 0);
+  init_mazecache(&cache, 2);
+  graph = junction_graph(&cache, maze, &mazeparam);
+  assert(graph == &cache.junction);
+  assert(junction_graph(&cache, maze, &mazeparam) == graph);
+  assert(graph -> nodes < mazeparam.rows * mazeparam.cols / 2);
+  assert(graph -> edges % 2 == 0);
+  start = mazeparam.startrow * mazeparam.cols + mazeparam.startcol;
+  assert(graph -> nodeof [start] != -1);
+  assert(graph -> node [graph -> nodeof [start]] == start);
+  mazeparam.graph = graph;
+  pentti.steps = 0;
+  assert(junction(&pentti, maze, &mazeparam) == 0);
+  assert(pathlength(maze, &mazeparam) == 38);
+  assert(pentti.steps < graph -> nodes);
+  free_overlay(&mazeparam);
+  free(maze);
+  release_mazecache(&cache);
+  assert(cache.junction.nodeof != NULL);
+  release_mazecache(&cache);
+  assert(cache.junction.nodeof == NULL);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      test_hpa
+*
+* DESCRIPTION   HPA* graph construction and search test
+*
+* ARGUMENTS     filename    Maze file name
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The graph is built with one and with three threads, and
+*               the distance tables must agree. The smoothed path must
+*               have the 38 steps of Dijkstra's algorithm, and in an open
+*               room the straight distance of 29 steps, where the
+*               entrances alone make 37.
+*
+\**************************************************************************/
+
+void test_hpa(char *filename)
+{
+  char        *scratch = "test_hpa.tmp";
+  FILE        *f;
+  mazeparam_t mazeparam;
+  char        *maze = NULL;
+  pentti_t    pentti;
+  hpa_graph_t single, threaded;
+  assert(mazeinit(filename, &maze, &mazeparam) == 0);
+  assert(init_overlay(&mazeparam) == 0);
+  assert(build_hpa_graph(&single, maze, &mazeparam, 8, 1) == 0);
+  assert(build_hpa_graph(&threaded, maze, &mazeparam, 8, 3) == 0);
+  assert(single.clusters == 3 * 5);
+  assert(single.nodes == threaded.nodes);
+  assert(single.offset [single.clusters] == threaded.offset [threaded.clusters]);
+  assert(memcmp(single.dist, threaded.dist,
+                single.offset [single.clusters] * sizeof (int)) == 0);
+  for (int n = 0; n < single.nodes; n++) {
+    assert(hpa_node(&single, &mazeparam, single.node [n]) == n);
+    for (int h = 0; h < 4; h++) {
+      int m = single.across [4 * n + h];
+      if (m != -1) assert(single.across [4 * m + ((h + 2) & 3)] == n);
+    }
+  }
+  free_hpa_graph(&threaded);
+  mazeparam.hpa = &single;
+  pentti.steps = 0;
+  assert(hpa(&pentti, maze, &mazeparam) == 0);
+  assert(pathlength(maze, &mazeparam) == 38);
+  free_hpa_graph(&single);
+  free_overlay(&mazeparam);
+  free(maze);
+  f = fopen(scratch, "w");
+  for (int r = 0; r < 27; r++) {
+    for (int c = 0; c < 69; c++) {
+      char square = ((r == 0) || (r == 26) || (c == 0) || (c == 68)) ? '#' : ' ';
+      if ((r == 0) && (c == 5)) square = 'E';
+      if ((r == 25) && (c == 10)) square = '^';
+      fputc(square, f);
+    }
+    fputc('\n', f);
+  }
+  fclose(f);
+  assert(mazeinit(scratch, &maze, &mazeparam) == 0);
+  mazeparam.out = fopen("/dev/null", "w");
+  assert(init_overlay(&mazeparam) == 0);
+  assert(build_hpa_graph(&single, maze, &mazeparam, HPA_CLUSTER_SIZE, 1) == 0);
+  mazeparam.hpa = &single;
+  pentti.steps = 0;
+  assert(hpa(&pentti, maze, &mazeparam) == 0);
+  assert(pathlength(maze, &mazeparam) == 29);
+  free_hpa_graph(&single);
+  free_overlay(&mazeparam);
+  fclose(mazeparam.out);
+  free(maze);
+  remove(scratch);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      test_parallel_bfs
+*
+* DESCRIPTION   Parallel BFS shortest path test
+*
+* ARGUMENTS     filename    Maze file name
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         Runs with one and with four threads regardless of the
+*               processor count. A step is a BFS layer, so the step count
+*               equals the path length, and the intermediate and final
+*               states must print as those of bitboard().
+*
+\**************************************************************************/
+
+void test_parallel_bfs(char *filename)
+{
+  mazeparam_t mazeparam;
+  char        *maze = NULL;
+  char        *text [2] = {NULL, NULL};
+  size_t      textsize [2] = {0, 0};
+  pentti_t    pentti;
+  assert(mazeinit(filename, &maze, &mazeparam) == 0);
+  assert(init_overlay(&mazeparam) == 0);
+  mazeparam.out = open_memstream(&text [0], &textsize [0]);
+  pentti.steps = 0;
+  assert(bitboard(&pentti, maze, &mazeparam) == 0);
+  fclose(mazeparam.out);
+  free_overlay(&mazeparam);
+  free(maze);
+  maze = NULL;
+  for (int threads = 1; threads <= 4; threads += 3) {
+    assert(mazeinit(filename, &maze, &mazeparam) == 0);
+    assert(init_overlay(&mazeparam) == 0);
+    mazeparam.threads = threads;
+    mazeparam.out = open_memstream(&text [1], &textsize [1]);
+    pentti.steps = 0;
+    assert(parallel_bfs(&pentti, maze, &mazeparam) == 0);
+    fclose(mazeparam.out);
+    assert(pathlength(maze, &mazeparam) == 38);
+    assert(pentti.steps == 38);
+    assert(strstr(text [1], "Intermediate state at 20th step") != NULL);
+    assert(strcmp(text [0], text [1]) == 0);
+    free(text [1]);
+    text [1] = NULL;
+    free_overlay(&mazeparam);
+    free(maze);
+    maze = NULL;
+  }
+  free(text [0]);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      test_tiled_bfs
+*
+* DESCRIPTION   Out of core tiled search test
+*
+* ARGUMENTS     filename    Maze file name
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         Tiles of 8 x 8 squares and a cache of two tiles force the
+*               tiles to be written back and read again. The path length
+*               must still be the 38 steps of Dijkstra's algorithm. A text
+*               maze is refused.
+*
+\**************************************************************************/
+
+void test_tiled_bfs(char *filename)
+{
+  mazeparam_t mazeparam;
+  char        *maze = NULL, *text = NULL;
+  char        *scratch = "test_tiled_bfs.tmp";
+  size_t      textsize = 0;
+  tilestore_t store;
+  tileslot_t  *slot;
+  FILE        *f;
+  assert(mazeinit(filename, &maze, &mazeparam) == 0);
+  f = fopen(scratch, "wb");
+  assert(packmaze(maze, &mazeparam, f) == 0);
+  fclose(f);
+  assert(open_tilestore(&store, scratch, 8, 2) == 0);
+  assert(store.tiles == 3 * 5);
+  slot = tile_slot(&store, 0);
+  assert(slot -> wall [0] == 1);                       /* Corner */
+  assert(slot -> wall [8 + 1] == (maze [mazeparam.cols + 1] == '#'));
+  slot -> state [9] = 5;
+  slot -> dirty = 1;
+  assert(tile_slot(&store, 1) != slot);
+  assert(tile_slot(&store, 2) == slot);                /* Reused */
+  assert(store.writes == 1);
+  assert(tile_slot(&store, 0) -> state [9] == 5);
+  close_tilestore(&store);
+  f = open_memstream(&text, &textsize);
+  assert(tiled_bfs(scratch, f, 8, 2) == 0);
+  fclose(f);
+  assert(strstr(text, "path has 38 steps") != NULL);
+  free(text);
+  f = open_memstream(&text, &textsize);
+  assert(tiled_bfs(filename, f, 8, 2) == 1);
+  fclose(f);
+  free(text);
+  free(maze);
+  remove(scratch);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      test_cached_maze
+*
+* DESCRIPTION   Shared maze loading and marker overlay test
+*
+* ARGUMENTS     filename    Maze file name
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The maze is loaded once for both runs, and the solvers
+*               leave it untouched. Each run has its own overlay.
+*
+\**************************************************************************/
+
+void test_cached_maze(char *filename)
+{
+  mazeparam_t mazeparam, other;
+  const char  *maze, *other_maze;
+  char        *copy;
+  pentti_t    pentti;
+  mazecache_t cache;
+  init_mazecache(&cache, 2);
+  assert(cached_maze(&cache, filename, &maze, &mazeparam) == 0);
+  assert(maze != NULL);
+  assert(cached_maze(&cache, filename, &other_maze, &other) == 0);
+  assert(other_maze == maze);
+  assert(other.rows == mazeparam.rows);
+  copy = (char *) malloc(mazeparam.rows * mazeparam.cols);
+  memcpy(copy, maze, mazeparam.rows * mazeparam.cols);
+  assert(init_overlay(&mazeparam) == 0);
+  assert(init_overlay(&other) == 0);
+  mazeparam.frontier = FRONTIER_HEAP;
+  mazeparam.pledge_enable = 0;
+  pentti.steps = 0;
+  assert(dijkstra(&pentti, maze, &mazeparam) == 0);
+  pentti.steps = 0;
+  assert(bitboard(&pentti, maze, &other) == 0);
+  assert(pathlength(maze, &mazeparam) == 38);
+  assert(pathlength(maze, &other) == 38);
+  assert(memcmp(copy, maze, mazeparam.rows * mazeparam.cols) == 0);
+  free_overlay(&mazeparam);
+  free_overlay(&other);
+  free(copy);
+  release_mazecache(&cache);
+  assert(cache.maze != NULL);
+  release_mazecache(&cache);
+  assert(cache.maze == NULL);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      test_rle
+*
+* DESCRIPTION   Run-length encoded row test
+*
+* ARGUMENTS     filename    Maze file name
+*
+* GLOBALS       algorithms
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         Every square, also outside the maze, must read the same
+*               from the rows as from the maze map, for the text and the
+*               binary file alike, and every algorithm loading the maze
+*               must print the same results from either.
+*
+\**************************************************************************/
+
+void test_rle(char *filename)
+{
+  mazeparam_t mazeparam, runs;
+  rlemaze_t   rle;
+  char        *maze = NULL;
+  char        *row, *dense = NULL, *sparse = NULL;
+  char        *scratch = "test_rle.tmp";
+  size_t      denselen = 0, sparselen = 0;
+  algorithm_t *chosen [sizeof (algorithms) / sizeof (algorithms [0])];
+  int         nchosen = 0;
+  filelist_t  list;
+  budget_t    nobudget = {0, 0};
+  FILE        *f;
+  assert(mazeinit(filename, &maze, &mazeparam) == 0);
+  assert(mazeparam.rle == NULL);
+  for (int pass = 0; pass < 2; pass++) {
+    assert(mazeinit_rle(pass ? scratch : filename, &rle, &runs) == 0);
+    assert(runs.rle == &rle);
+    assert(runs.rows == mazeparam.rows);
+    assert(runs.cols == mazeparam.cols);
+    assert(runs.startrow == mazeparam.startrow);
+    assert(runs.startcol == mazeparam.startcol);
+    assert(runs.exits == mazeparam.exits);
+    assert(rle.rows == mazeparam.rows);
+    assert(rle.runs < (long long) mazeparam.rows * mazeparam.cols / 2);
+    for (int r = -1; r <= mazeparam.rows; r++) {
+      for (int c = -1; c <= mazeparam.cols; c++) {
+        assert(mazeval(NULL, &runs, r, c) == mazeval(maze, &mazeparam, r, c));
+      }
+    }
+    free_rle(&rle);
+    f = fopen(scratch, "wb");
+    assert(packmaze(maze, &mazeparam, f) == 0);
+    fclose(f);
+  }
+  remove(scratch);
+  free(maze);
+  row = (char *) malloc(60000);
+  memset(row, ' ', 60000);
+  row [0] = row [59999] = '#';
+  memset(&rle, 0, sizeof (rlemaze_t));
+  assert(rle_append_row(&rle, row, 60000) == 0);
+  assert(rle_append_row(&rle, row, 60000) == 0);
+  assert(rle.runs == 6);
+  assert(rle_val(&rle, 1, 0) == '#');
+  assert(rle_val(&rle, 1, 1) == ' ');
+  assert(rle_val(&rle, 1, 59998) == ' ');
+  assert(rle_val(&rle, 1, 59999) == '#');
+  memset(row, 0, 60000);
+  rle_row(&rle, 1, row, 60000);
+  assert((row [0] == '#') && (row [30000] == ' ') && (row [59999] == '#'));
+  free_rle(&rle);
+  free(row);
+  for (algorithm_t *a = algorithms; a -> name; a++) {
+    if (! (a -> flags & OUT_OF_CORE)) chosen [nchosen ++] = a;
+  }
+  memset(&list, 0, sizeof (filelist_t));
+  assert(add_mazefile(&list, filename) == 0);
+  f = open_memstream(&dense, &denselen);
+  assert(run_batch(&list, chosen, nchosen, 2, 0, nobudget, f) == 0);
+  fclose(f);
+  f = open_memstream(&sparse, &sparselen);
+  assert(run_batch(&list, chosen, nchosen, 2, 1, nobudget, f) == 0);
+  fclose(f);
+  assert(sparselen == denselen);
+  assert(memcmp(sparse, dense, denselen) == 0);
+  free(dense);
+  free(sparse);
+  free_filelist(&list);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      test_cellmask
+*
+* DESCRIPTION   Wall mask layer test
+*
+* ARGUMENTS     filename    Maze file name
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         The walls of the maze and of the sentinel ring must test
+*               the same with the layer as by mazeval() without it, and
+*               the sentinel bytes must all be zero.
+*
+\**************************************************************************/
+
+void test_cellmask(char *filename)
+{
+  mazeparam_t mazeparam, plain;
+  char        *maze = NULL;
+  assert(mazeinit(filename, &maze, &mazeparam) == 0);
+  assert(mazeparam.cellmask != NULL);
+  plain = mazeparam;
+  plain.cellmask = NULL;
+  for (int r = -1; r <= mazeparam.rows; r++) {
+    for (int c = -1; c <= mazeparam.cols; c++) {
+      assert(walkable(maze, &mazeparam, r, c) == walkable(maze, &plain, r, c));
+      if (outside(&mazeparam, r, c)) {
+        assert(mazeparam.cellmask [(long long) (r + 1) * (mazeparam.cols + 2) + c + 1] == 0);   /* Sentinel */
+        continue;
+      }
+      assert(nextto_exit(maze, &mazeparam, r, c) == nextto_exit(maze, &plain, r, c));
+      assert(open_mask(maze, &mazeparam, r, c) == open_mask(maze, &plain, r, c));
+    }
+  }
+  assert(nextto_exit(maze, &mazeparam, 1, 7) == 1);
+  assert(walkable(maze, &mazeparam, 0, 7) == 0);   /* The exit */
+  assert(open_mask(maze, &mazeparam, 1, 7) == (1 << 0));
+  free(maze);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      write_random_maze
+*
+* DESCRIPTION   Writes a random maze file with loops
+*
+* ARGUMENTS     filename    Maze file name
+*               n           Number of rooms per side
+*               seed        Random number seed
+*               edge        Flag for a start in the west wall
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         A depth first carved maze of n x n rooms, with every
+*               eighth wall between rooms knocked down afterwards to make
+*               loops. The start is in the middle, or in the west wall
+*               for the wall follower, and the exit in the east wall. A
+*               fixed generator keeps the mazes the same on every
+*               platform.
+*
+\**************************************************************************/
+
+void write_random_maze(char *filename, int n, unsigned int seed, int edge)
+{
+  int      side = 2 * n + 1;
+  char     *grid = (char *) malloc((size_t) side * side);
+  int      *stack = (int *) malloc((size_t) n * n * sizeof(int));
+  int      depth = 0;
+  FILE     *f = fopen(filename, "w");
+  memset(grid, '#', (size_t) side * side);
+  grid [side + 1] = ' ';
+  stack [depth ++] = 0;
+  while (depth > 0) {
+    int room = stack [depth - 1];
+    int r = room / n, c = room % n;
+    int options [4], count = 0;
+    for (int h = 0; h < 4; h++) {
+      int nr = r + headingrow [h], nc = c + headingcol [h];
+      if (   (nr >= 0) && (nr < n) && (nc >= 0) && (nc < n)
+          && (grid [(2 * nr + 1) * side + 2 * nc + 1] == '#')) {
+        options [count ++] = h;
+      }
+    }
+    if (count == 0) {
+      depth --;
+      continue;
+    }
+    seed = seed * 1103515245u + 12345u;
+    int h = options [(seed >> 16) % count];
+    grid [(2 * r + 1 + headingrow [h]) * side + 2 * c + 1 + headingcol [h]] = ' ';
+    grid [(2 * (r + headingrow [h]) + 1) * side + 2 * (c + headingcol [h]) + 1] = ' ';
+    stack [depth ++] = (r + headingrow [h]) * n + c + headingcol [h];
+  }
+  for (int i = side; i < side * (side - 1); i++) {
+    int r = i / side, c = i % side;
+    if ((c == 0) || (c == side - 1) || (((r + c) & 1) == 0)) continue;
+    seed = seed * 1103515245u + 12345u;
+    if (((seed >> 16) & 7) == 0) grid [i] = ' ';
+  }
+  grid [(2 * (n / 2) + 1) * side + (edge ? 0 : 2 * (n / 2) + 1)] = '^';
+  grid [(2 * (n / 3) + 1) * side + side - 1] = 'E';
+  for (int r = 0; r < side; r++) fprintf(f, "%.*s\n", side, grid + r * side);
+  fclose(f);
+  free(stack);
+  free(grid);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      test_follow_walls
+*
+* DESCRIPTION   Table driven wall follower test
+*
+* ARGUMENTS     filename    Maze file name
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         Pledge and the wall follower must make the same steps and
+*               marks with follow_walls() as on the square by square path
+*               taken without the wall mask layer.
+*
+\**************************************************************************/
+
+void test_follow_walls(char *filename)
+{
+  mazeparam_t mazeparam, plain;
+  char        *maze = NULL;
+  char        *trail;
+  pentti_t    jumping, walking;
+  assert(mazeinit(filename, &maze, &mazeparam) == 0);
+  mazeparam.out = fopen("/dev/null", "w");
+  for (int enable = 0; enable < 2; enable++) {
+    int rv;
+    mazeparam.pledge_enable = enable;
+    assert(init_overlay(&mazeparam) == 0);
+    jumping.steps = 0;
+    rv = pledge(&jumping, maze, &mazeparam);
+    trail = mazeparam.overlay;
+    plain = mazeparam;
+    plain.cellmask = NULL;
+    assert(init_overlay(&plain) == 0);
+    walking.steps = 0;
+    assert(pledge(&walking, maze, &plain) == rv);
+    if (rv == 0) {
+      assert(jumping.steps == walking.steps);
+      assert(jumping.row == walking.row);
+      assert(jumping.col == walking.col);
+      assert(jumping.unfolded_heading == walking.unfolded_heading);
+    }
+    assert(memcmp(trail, plain.overlay, (size_t) mazeparam.rows * mazeparam.cols) == 0);
+    free(trail);
+    free_overlay(&plain);
+  }
+  fclose(mazeparam.out);
+  free(maze);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      test_walkguard
+*
+* DESCRIPTION   Unsolvable maze and walker budget test
+*
+* ARGUMENTS     filename    Maze file name
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         A closet, a pocket in the west wall and a large room are
+*               sealed from their exits. The walkers must give them up
+*               with and without the wall mask layer. A budget of 50 steps
+*               must stop Pledge on the given maze. Dijkstra's algorithm
+*               must print no solution for the closet.
+*
+\**************************************************************************/
+
+void test_walkguard(char *filename)
+{
+  char        *scratch = "test_walkguard.tmp";
+  char        *closet [] = {"#######E#", "#^ #    #", "#########", NULL};
+  char        *pocket [] = {"#######E#", "^  #    #", "#  #    #", "#########", NULL};
+  char        *maze = NULL, *text = NULL;
+  size_t      textsize = 0;
+  mazeparam_t mazeparam, plain;
+  mazecache_t cache;
+  pentti_t    pentti;
+  FILE        *f;
+  for (int m = 0; m < 3; m++) {
+    f = fopen(scratch, "w");
+    if (m < 2) {
+      for (char **row = (m == 0) ? closet : pocket; *row; row++) fprintf(f, "%s\n", *row);
+    }
+    else {
+      for (int r = 0; r < 40; r++) {
+        for (int c = 0; c < 40; c++) {
+          char square = ' ';
+          if ((r < 2) || (r == 39) || (c == 0) || (c == 39)) square = '#';
+          if ((r == 0) && (c == 20)) square = 'E';
+          if ((r == 20) && (c == 20)) square = '^';
+          fputc(square, f);
+        }
+        fputc('\n', f);
+      }
+    }
+    fclose(f);
+    assert(mazeinit(scratch, &maze, &mazeparam) == 0);
+    mazeparam.out = fopen("/dev/null", "w");
+    mazeparam.pledge_enable = (int) (m != 1);
+    plain = mazeparam;
+    plain.cellmask = NULL;
+    assert(init_overlay(&mazeparam) == 0);
+    pentti.steps = 0;
+    assert(pledge(&pentti, maze, &mazeparam) == SOLVE_UNSOLVABLE);
+    if (m == 2) assert(pentti.steps > 200);
+    assert(init_overlay(&plain) == 0);
+    pentti.steps = 0;
+    assert(pledge(&pentti, maze, &plain) == SOLVE_UNSOLVABLE);
+    free_overlay(&mazeparam);
+    free_overlay(&plain);
+    fclose(mazeparam.out);
+    free(maze);
+  }
+  remove(scratch);
+  init_mazecache(&cache, 1);
+  cache.budget.steps = 50;
+  f = open_memstream(&text, &textsize);
+  assert(solvemaze(pledge, filename, PLEDGE_ENABLE, &cache, f) == SOLVE_UNSOLVABLE);
+  release_mazecache(&cache);
+  fclose(f);
+  assert(strstr(text, "within the budget, gave up after 50 steps") != NULL);
+  assert(strstr(text, "Solution") == NULL);
+  free(text);
+  text = NULL;
+  f = fopen(scratch, "w");
+  for (char **row = closet; *row; row++) fprintf(f, "%s\n", *row);
+  fclose(f);
+  f = open_memstream(&text, &textsize);
+  assert(solvemaze(dijkstra, scratch, 0, NULL, f) == SOLVE_NOT_FOUND);
+  fclose(f);
+  assert(strstr(text, "Exit not found") != NULL);
+  assert(strstr(text, "Solution") == NULL);
+  free(text);
+  remove(scratch);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      test_solve
+*
+* DESCRIPTION   Resumable solve and observer test
+*
+* ARGUMENTS     filename    Maze file name
+*
+* GLOBALS       -
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         Stepping in slices of any size must print and mark the
+*               same as pledge() and dijkstra(). A walk observed for its
+*               metrics only must leave the same trail as one without the
+*               wall mask layer.
+*
+\**************************************************************************/
+
+void test_solve(char *filename)
+{
+  mazeparam_t mazeparam, plain;
+  char        *maze = NULL;
+  char        *text [2] = {NULL, NULL};
+  char        *trail;
+  size_t      textsize [2];
+  long long   slices [3] = {1, 7, 1000};
+  solver_t    solvers [2] = {pledge, dijkstra};
+  pentti_t    pentti;
+  solve_t     solve;
+  observer_t  marker, snapshots, metrics;
+  metrics_t   totals;
+  assert(mazeinit(filename, &maze, &mazeparam) == 0);
+  mazeparam.pledge_enable = 1;
+  mazeparam.frontier = FRONTIER_HEAP;
+  for (int a = 0; a < 2; a++) {
+    assert(init_overlay(&mazeparam) == 0);
+    mazeparam.out = open_memstream(&text [0], &textsize [0]);
+    assert(solvers [a](&pentti, maze, &mazeparam) == SOLVE_OK);
+    fclose(mazeparam.out);
+    assert(strstr(text [0], "Intermediate state at 20th step") != NULL);
+    trail = mazeparam.overlay;
+    for (int i = 0; i < 3; i++) {
+      assert(init_overlay(&mazeparam) == 0);
+      mazeparam.out = open_memstream(&text [1], &textsize [1]);
+      init_solve(&solve, &pentti, maze, &mazeparam);
+      init_observer(&marker, (a == 0) ? 200 : INT_MAX,
+                    (a == 0) ? mark_trail : mark_exploration, NULL, NULL);
+      init_observer(&snapshots, 201, print_snapshot, NULL, NULL);
+      init_observer(&metrics, 0, NULL, record_metrics, &totals);
+      attach_observer(&solve, &marker);
+      attach_observer(&solve, &snapshots);
+      attach_observer(&solve, &metrics);
+      assert(solve.until == ((a == 0) ? 201 : INT_MAX));
+      assert(((a == 0) ? walk_init(&solve) : dijkstra_init(&solve)) == 0);
+      while (solve.step(&solve, slices [i]) == 0) assert(solve.done == 0);
+      assert(solve.finish(&solve) == SOLVE_OK);
+      fclose(mazeparam.out);
+      assert(totals.status == SOLVE_OK);
+      assert(totals.steps == pentti.steps);
+      assert((a == 0) ? (totals.moves > 0) : (totals.moves == pentti.steps));
+      assert(strcmp(text [0], text [1]) == 0);
+      assert(memcmp(trail, mazeparam.overlay, (size_t) mazeparam.rows * mazeparam.cols) == 0);
+      free(text [1]);
+      free_overlay(&mazeparam);
+    }
+    free(trail);
+    free(text [0]);
+  }
+  mazeparam.out = fopen("/dev/null", "w");
+  assert(init_overlay(&mazeparam) == 0);
+  init_solve(&solve, &pentti, maze, &mazeparam);
+  init_observer(&metrics, 0, NULL, record_metrics, &totals);
+  attach_observer(&solve, &metrics);
+  assert(solve.until == 0);
+  assert(walk_init(&solve) == 0);
+  assert(run_solve(&solve, 3) == SOLVE_OK);
+  plain = mazeparam;
+  plain.cellmask = NULL;
+  assert(init_overlay(&plain) == 0);
+  init_solve(&solve, &pentti, maze, &plain);
+  assert(walk_init(&solve) == 0);
+  assert(run_solve(&solve, LLONG_MAX) == SOLVE_OK);
+  assert(pentti.steps == totals.steps);
+  assert(memcmp(plain.overlay, mazeparam.overlay, (size_t) mazeparam.rows * mazeparam.cols) == 0);
+  free_overlay(&plain);
+  free_overlay(&mazeparam);
+  assert(init_overlay(&mazeparam) == 0);
+  init_solve(&solve, &pentti, maze, &mazeparam);
+  assert(dijkstra_init(&solve) == 0);
+  assert(solve.step(&solve, 5) == 0);
+  assert(solve.finish(&solve) == SOLVE_NOT_FOUND);   /* Abandoned */
+  assert(pentti.steps == 5);
+  free_overlay(&mazeparam);
+  fclose(mazeparam.out);
+  free(maze);
+}
+
+
+
+/**************************************************************************\
+*
+* FUNCTION      test_batch
+*
+* DESCRIPTION   Batch mode file collection and output order test
+*
+* ARGUMENTS     filename    Maze file name
+*
+* GLOBALS       algorithms
+*
+* RETURNS       -
+*
+* HISTORY       2026 10 18   JPT   First implementation
+*
+* NOTES         Two files and two algorithms on three threads must print
+*               exactly what the four runs print one after another. Any
+*               number of failed jobs must give the error code 1.
+*
+\**************************************************************************/
+
+void test_batch(char *filename)
+{
+  char        *scratch = "test_batch.tmp";
+  filelist_t  list;
+  budget_t    nobudget = {0, 0};
+  algorithm_t *chosen [2] = {findalgorithm("dijkstra"), findalgorithm("junction")};
+  char        *seq = NULL, *par = NULL;
+  size_t      seqlen = 0, parlen = 0;
+  FILE        *f;
+  memset(&list, 0, sizeof (filelist_t));
+  assert(add_mazefile(&list, "../data") == 0);
+  assert(list.files == 2);
+  assert(strstr(list.name [0], "maze-task-first.txt") != NULL);
+  assert(add_mazefile(&list, filename) == 0);
+  assert(list.files == 3);
+  f = open_memstream(&seq, &seqlen);
+  for (int i = 1; i < list.files; i++) {
+    for (int a = 0; a < 2; a++) runalgorithm(chosen [a], list.name [i], NULL, f);
+  }
+  fclose(f);
+  free(list.name [0]);   /* Leaves the files run above */
+  list.name [0] = list.name [1];
+  list.name [1] = list.name [2];
+  list.files = 2;
+  f = open_memstream(&par, &parlen);
+  assert(run_batch(&list, chosen, 2, 3, 0, nobudget, f) == 0);
+  fclose(f);
+  assert(parlen == seqlen);
+  assert(memcmp(par, seq, seqlen) == 0);
+  free(seq);
+  free(par);
+  free_filelist(&list);
+  f = fopen(scratch, "w");
+  fprintf(f, "#######E#\n#^ #    #\n#########\n");
+  fclose(f);
+  memset(&list, 0, sizeof (filelist_t));
+  for (int i = 0; i < 3; i++) assert(add_mazefile(&list, scratch) == 0);
+  f = fopen("/dev/null", "w");
+  assert(run_batch(&list, chosen, 1, 2, 0, nobudget, f) == 1);
+  fclose(f);
+  free_filelist(&list);
+  remove(scratch);
+}
+
+
+
 /************************************************************************** \
 *
 * FUNCTION      test_mazeinit
@@ -315,8 +1818,12 @@ void test_mazeinit(char *filename, char **maze, mazeparam_t *mazeparam)
 {
   int errcode;
   mazeparam -> olist = NULL;
+  mazeparam -> overlay = NULL;
+  mazeparam -> rle = NULL;
+  mazeparam -> cellmask = NULL;
+  memset(&(mazeparam -> budget), 0, sizeof (budget_t));
   errcode = measuremaze(filename, mazeparam);
-  assert(mazeparam -> rows == 190);
+  assert(mazeparam -> rows == 19);
   assert(mazeparam -> cols == 37);
   assert(errcode == 0);
   errcode = loadmaze(filename, maze, mazeparam);
@@ -375,6 +1882,35 @@ int main () {
   test_outside(&mazeparam);
   test_mazeval(maze, &mazeparam);
   test_dijkstra(maze, &mazeparam);
+  test_uniques();
+  test_pool();
+  test_heap();
+  test_bucket();
+  test_mapmaze(filename);
+  test_wide_maze();
+  test_packmaze(filename);
+  test_frontiers(filename);
+  test_bitboard(filename);
+  test_bidirectional(filename);
+  test_astar(filename);
+  test_jps(filename);
+  test_junction(filename);
+  test_hpa(filename);
+  test_parallel_bfs(filename);
+  test_tiled_bfs(filename);
+  test_cached_maze(filename);
+  test_rle(filename);
+  test_cellmask(filename);
+  test_follow_walls(filename);
+  test_follow_walls("../data/maze-task-second.txt");
+  for (unsigned int seed = 1; seed <= 8; seed++) {
+    write_random_maze("test_follow_walls.tmp", 40, seed, (int) (seed & 1));
+    test_follow_walls("test_follow_walls.tmp");
+  }
+  remove("test_follow_walls.tmp");
+  test_walkguard(filename);
+  test_solve(filename);
+  test_batch(filename);
   free(maze);
   return (0);
 }